@@ -0,0 +1,48 @@
+#include "ActiveObject.hpp"
+
+ActiveObject::ActiveObject(const std::string& name)
+    : name(name), stop(false), pending(0), done(0), thread(&ActiveObject::run, this) {}
+
+ActiveObject::~ActiveObject() {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        stop = true;
+        cv.notify_all();
+    }
+    thread.join();
+}
+
+void ActiveObject::send(std::function<void()> message) {
+    std::unique_lock<std::mutex> lock(mtx);
+    messages.push(std::move(message));
+    pending++;
+    cv.notify_one();
+}
+
+const std::string& ActiveObject::getName() const {
+    return name;
+}
+
+size_t ActiveObject::depth() const {
+    return pending;
+}
+
+size_t ActiveObject::processed() const {
+    return done;
+}
+
+void ActiveObject::run() {
+    while (true) {
+        std::function<void()> message;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this] { return stop || !messages.empty(); });
+            if (stop && messages.empty()) return;
+            message = std::move(messages.front());
+            messages.pop();
+        }
+        message();
+        done++;
+        pending--;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef ACTIVE_OBJECT_HPP
+#define ACTIVE_OBJECT_HPP
+
+#include <string>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Active Object: a thread of its own that runs the messages sent to it one at a time, in the order
+// they were sent. Senders never wait for a message to run.
+class ActiveObject {
+public:
+    explicit ActiveObject(const std::string& name);
+    // Runs what is still queued, then stops the thread
+    ~ActiveObject();
+
+    void send(std::function<void()> message);
+
+    const std::string& getName() const;
+    // Messages sent and not finished yet (the running one included)
+    size_t depth() const;
+    // Messages finished so far
+    size_t processed() const;
+
+private:
+    void run();
+
+    std::string name;
+    std::queue<std::function<void()>> messages;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stop;
+    std::atomic<size_t> pending;
+    std::atomic<size_t> done;
+    std::thread thread;         // last, it starts once everything else is set up
+};
+
+#endif // ACTIVE_OBJECT_HPP
@@ -0,0 +1,202 @@
+#include "BatchSolver.hpp"
+#include "MSTSolver.hpp"
+#include <cstdint>
+
+// ---------------------------- GraphBatch ----------------------------
+GraphBatch::GraphBatch() {
+    edgeOffsets.push_back(0);
+}
+
+size_t GraphBatch::addGraph(int num_vertices, const std::vector<Edge>& graphEdges) {
+    size_t g = beginGraph(num_vertices);
+    edges.insert(edges.end(), graphEdges.begin(), graphEdges.end());
+    edgeOffsets.back() = edges.size();
+    return g;
+}
+
+size_t GraphBatch::beginGraph(int num_vertices) {
+    vertexCounts.push_back(num_vertices);
+    edgeOffsets.push_back(edges.size());
+    return vertexCounts.size() - 1;
+}
+
+void GraphBatch::addEdge(int u, int v, int weight) {
+    edges.push_back(Edge(u, v, weight));
+    edgeOffsets.back() = edges.size();
+}
+
+size_t GraphBatch::size() const {
+    return vertexCounts.size();
+}
+
+int GraphBatch::getNumVertices(size_t g) const {
+    return vertexCounts[g];
+}
+
+const Edge* GraphBatch::edgesBegin(size_t g) const {
+    return edges.data() + edgeOffsets[g];
+}
+
+const Edge* GraphBatch::edgesEnd(size_t g) const {
+    return edges.data() + edgeOffsets[g + 1];
+}
+
+void GraphBatch::reserve(size_t numGraphs, size_t numEdges) {
+    vertexCounts.reserve(numGraphs);
+    edgeOffsets.reserve(numGraphs + 1);
+    edges.reserve(numEdges);
+}
+
+size_t GraphBatch::memoryFor(int num_vertices, size_t num_edges) {
+    size_t bytes = sizeof(int) + 2 * sizeof(size_t) + num_edges * sizeof(Edge);
+    // the result slot of V-1 edges, and the Graph of the fallback solve above the bitset limit
+    bytes += sizeof(long long) + sizeof(int) + 1 + num_vertices * sizeof(Edge);
+    if (num_vertices > MAX_BATCH_VERTICES) {
+        bytes += Graph::memoryFor(num_vertices, num_edges);
+    }
+    return bytes;
+}
+
+// ---------------------------- Bitset Prim ----------------------------
+// Dense Prim for V <= 64: the adjacency is a 64x64 weight matrix plus one bitmask per row, and
+// the vertices still outside the tree are a single uint64_t. No heap, no connectivity DFS, and
+// a disconnected graph shows up as an empty frontier. Writes the MST to out, returns its size
+// or -1 if the graph is not connected.
+static int bitsetPrim(int numVertices, const Edge* begin, const Edge* end, Edge* out, long long& totalWeight) {
+    int weight[MAX_BATCH_VERTICES][MAX_BATCH_VERTICES];
+    uint64_t adjacent[MAX_BATCH_VERTICES] = {};
+    totalWeight = 0;
+    if (numVertices <= 1) {
+        return 0;
+    }
+
+    for (const Edge* edge = begin; edge != end; ++edge) {
+        int u = edge->u, v = edge->v;
+        if (u < 0 || u >= numVertices || v < 0 || v >= numVertices || u == v) {
+            continue;
+        }
+        // like Graph::addEdge, the first edge between two vertices wins
+        if (adjacent[u] & (uint64_t(1) << v)) {
+            continue;
+        }
+        adjacent[u] |= uint64_t(1) << v;
+        adjacent[v] |= uint64_t(1) << u;
+        weight[u][v] = edge->weight;
+        weight[v][u] = edge->weight;
+    }
+
+    int key[MAX_BATCH_VERTICES];
+    int parent[MAX_BATCH_VERTICES];
+    uint64_t all = numVertices == 64 ? ~uint64_t(0) : (uint64_t(1) << numVertices) - 1;
+    uint64_t outside = all & ~uint64_t(1);      // start from vertex 0
+    uint64_t frontier = adjacent[0];            // outside vertices with a finite key
+    for (uint64_t bits = frontier; bits; bits &= bits - 1) {
+        int v = __builtin_ctzll(bits);
+        key[v] = weight[0][v];
+        parent[v] = 0;
+    }
+
+    int size = 0;
+    while (outside) {
+        uint64_t candidates = frontier & outside;
+        if (!candidates) {
+            return -1;
+        }
+        int best = __builtin_ctzll(candidates);
+        for (uint64_t bits = candidates & (candidates - 1); bits; bits &= bits - 1) {
+            int v = __builtin_ctzll(bits);
+            if (key[v] < key[best]) {
+                best = v;
+            }
+        }
+
+        outside &= ~(uint64_t(1) << best);
+        out[size++] = Edge(parent[best], best, key[best]);
+        totalWeight += key[best];
+
+        for (uint64_t bits = adjacent[best] & outside; bits; bits &= bits - 1) {
+            int v = __builtin_ctzll(bits);
+            uint64_t bit = uint64_t(1) << v;
+            if (!(frontier & bit) || weight[best][v] < key[v]) {
+                key[v] = weight[best][v];
+                parent[v] = best;
+                frontier |= bit;
+            }
+        }
+    }
+    return size;
+}
+
+// Graphs above MAX_BATCH_VERTICES go through the regular solver
+static int fallbackPrim(int numVertices, const Edge* begin, const Edge* end, Edge* out, long long& totalWeight) {
+    Graph graph(numVertices);
+    for (const Edge* edge = begin; edge != end; ++edge) {
+        graph.addEdge(edge->u, edge->v, edge->weight);
+    }
+    totalWeight = 0;
+    if (numVertices <= 1) {
+        return 0;
+    }
+    std::vector<Edge> mst = PrimSolver().solve(graph);
+    if (mst.empty()) {
+        return -1;
+    }
+    for (size_t i = 0; i < mst.size(); ++i) {
+        out[i] = mst[i];
+        totalWeight += mst[i].weight;
+    }
+    return static_cast<int>(mst.size());
+}
+
+// ---------------------------- Batch ----------------------------
+BatchResult solveBatch(const GraphBatch& batch, ThreadPool& pool) {
+    size_t numGraphs = batch.size();
+    BatchResult result;
+    result.offsets.resize(numGraphs + 1);
+    result.mstSizes.assign(numGraphs, 0);
+    result.totalWeights.assign(numGraphs, 0);
+    result.connected.assign(numGraphs, 0);
+
+    // Every graph gets a fixed slot of V-1 edges, so the threads write their results in place
+    size_t running = 0;
+    for (size_t g = 0; g < numGraphs; ++g) {
+        result.offsets[g] = running;
+        running += batch.getNumVertices(g) > 0 ? batch.getNumVertices(g) - 1 : 0;
+    }
+    result.offsets[numGraphs] = running;
+    result.edges.assign(running, Edge(0, 0, 0));
+
+    pool.parallelFor(numGraphs, [&](size_t first, size_t last) {
+        for (size_t g = first; g < last; ++g) {
+            int numVertices = batch.getNumVertices(g);
+            Edge* out = result.edges.data() + result.offsets[g];
+            long long totalWeight = 0;
+            int size = numVertices <= MAX_BATCH_VERTICES
+                ? bitsetPrim(numVertices, batch.edgesBegin(g), batch.edgesEnd(g), out, totalWeight)
+                : fallbackPrim(numVertices, batch.edgesBegin(g), batch.edgesEnd(g), out, totalWeight);
+            result.connected[g] = size >= 0;
+            result.mstSizes[g] = size >= 0 ? size : 0;
+            result.totalWeights[g] = size >= 0 ? totalWeight : 0;
+        }
+    });
+    return result;
+}
+
+std::string printBatchResult(const BatchResult& result) {
+    size_t numGraphs = result.mstSizes.size();
+    std::string response = "Batch results for " + std::to_string(numGraphs) + " graphs:\n";
+    for (size_t g = 0; g < numGraphs; ++g) {
+        response += "Graph " + std::to_string(g) + ": ";
+        if (!result.connected[g]) {
+            response += "not connected\n";
+            continue;
+        }
+        response += "weight " + std::to_string(result.totalWeights[g]) + ",";
+        for (int i = 0; i < result.mstSizes[g]; ++i) {
+            const Edge& edge = result.edges[result.offsets[g] + i];
+            response += " " + std::to_string(edge.u) + "-" + std::to_string(edge.v) + "(" + std::to_string(edge.weight) + ")";
+        }
+        response += "\n";
+    }
+    return response;
+}
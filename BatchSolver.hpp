@@ -0,0 +1,59 @@
+#ifndef BATCH_SOLVER_HPP
+#define BATCH_SOLVER_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+// Graphs up to this size are solved with the bitset Prim, larger ones fall back to PrimSolver
+const int MAX_BATCH_VERTICES = 64;
+// A batch is for many small graphs: larger ones are refused (Newgraph takes them), and so is a
+// batch whose graphs, results and fallback solves would need more than MAX_BATCH_BYTES
+const int MAX_BATCH_GRAPH_VERTICES = 1 << 16;
+const size_t MAX_BATCH_BYTES = size_t(64) << 20;
+
+// Many small graphs packed into one contiguous arena, instead of one Graph (with a vector per
+// vertex) per request
+class GraphBatch {
+private:
+    std::vector<Edge> edges;            // all edges, graph after graph
+    std::vector<size_t> edgeOffsets;    // graph g owns edges[edgeOffsets[g], edgeOffsets[g + 1])
+    std::vector<int> vertexCounts;
+
+public:
+    GraphBatch();
+
+    // Append a graph, returns its index in the batch
+    size_t addGraph(int num_vertices, const std::vector<Edge>& graphEdges);
+    // Append a graph whose edges are pushed afterwards with addEdge()
+    size_t beginGraph(int num_vertices);
+    void addEdge(int u, int v, int weight);
+
+    size_t size() const;
+    int getNumVertices(size_t g) const;
+    const Edge* edgesBegin(size_t g) const;
+    const Edge* edgesEnd(size_t g) const;
+    void reserve(size_t numGraphs, size_t numEdges);
+
+    // Bytes a graph of that size needs in a batch, its result and solve included
+    static size_t memoryFor(int num_vertices, size_t num_edges);
+};
+
+// MSTs of a whole batch, packed the same way
+struct BatchResult {
+    std::vector<Edge> edges;            // MST edges, graph after graph
+    std::vector<size_t> offsets;        // graph g owns edges[offsets[g], offsets[g] + mstSizes[g])
+    std::vector<int> mstSizes;          // 0 if the graph is not connected
+    std::vector<long long> totalWeights;
+    std::vector<char> connected;
+};
+
+// Solve every graph of the batch, spread over the pool
+BatchResult solveBatch(const GraphBatch& batch, ThreadPool& pool = computePool());
+
+// Text rendering of a batch result, one line per graph
+std::string printBatchResult(const BatchResult& result);
+
+#endif // BATCH_SOLVER_HPP
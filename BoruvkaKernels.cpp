@@ -0,0 +1,124 @@
+#include "BoruvkaKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BORUVKA_X86_KERNELS
+#endif
+
+// Branch-free min update, compiles to a cmov
+static inline void relaxKey(uint64_t* best, int component, uint64_t key) {
+    uint64_t current = best[component];
+    best[component] = key < current ? key : current;
+}
+
+// Scalar reduction of the edges [begin, end), keys use the absolute edge index
+static void reduceRange(const int* eu, const int* ev, const int* ew, size_t begin, size_t end, const int* comp, uint64_t* best) {
+    for (size_t i = begin; i < end; ++i) {
+        int cu = comp[eu[i]];
+        int cv = comp[ev[i]];
+        if (cu != cv) {
+            uint64_t key = packEdgeKey(ew[i], static_cast<uint32_t>(i));
+            relaxKey(best, cu, key);
+            relaxKey(best, cv, key);
+        }
+    }
+}
+
+void cheapestEdgesScalar(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best) {
+    reduceRange(eu, ev, ew, 0, numEdges, comp, best);
+}
+
+#ifdef BORUVKA_X86_KERNELS
+// Both kernels gather the component labels of a whole block of edges and compare them in
+// registers, only the lanes that cross components reach the (scalar) keyed min-reduction.
+// In the later rounds almost all edges are internal, so a block usually costs three loads,
+// two gathers and one compare.
+
+__attribute__((target("avx2")))
+static void cheapestEdgesAVX2(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best) {
+    alignas(32) int cu[8], cv[8], w[8];
+    size_t i = 0;
+    for (; i + 8 <= numEdges; i += 8) {
+        __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(eu + i));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ev + i));
+        __m256i labelU = _mm256_i32gather_epi32(comp, u, 4);
+        __m256i labelV = _mm256_i32gather_epi32(comp, v, 4);
+        __m256i same = _mm256_cmpeq_epi32(labelU, labelV);
+        unsigned cross = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(same))) & 0xFFu;
+        if (cross == 0) {
+            continue;
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(cu), labelU);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(cv), labelV);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(w), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ew + i)));
+        while (cross) {
+            int lane = __builtin_ctz(cross);
+            cross &= cross - 1;
+            uint64_t key = packEdgeKey(w[lane], static_cast<uint32_t>(i + lane));
+            relaxKey(best, cu[lane], key);
+            relaxKey(best, cv[lane], key);
+        }
+    }
+    reduceRange(eu, ev, ew, i, numEdges, comp, best);
+}
+
+__attribute__((target("avx512f")))
+static void cheapestEdgesAVX512(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best) {
+    alignas(64) int cu[16], cv[16], w[16];
+    size_t i = 0;
+    for (; i + 16 <= numEdges; i += 16) {
+        __m512i u = _mm512_loadu_si512(eu + i);
+        __m512i v = _mm512_loadu_si512(ev + i);
+        __m512i labelU = _mm512_i32gather_epi32(u, comp, 4);
+        __m512i labelV = _mm512_i32gather_epi32(v, comp, 4);
+        unsigned cross = _mm512_cmpneq_epi32_mask(labelU, labelV);
+        if (cross == 0) {
+            continue;
+        }
+        _mm512_store_si512(cu, labelU);
+        _mm512_store_si512(cv, labelV);
+        _mm512_store_si512(w, _mm512_loadu_si512(ew + i));
+        while (cross) {
+            int lane = __builtin_ctz(cross);
+            cross &= cross - 1;
+            uint64_t key = packEdgeKey(w[lane], static_cast<uint32_t>(i + lane));
+            relaxKey(best, cu[lane], key);
+            relaxKey(best, cv[lane], key);
+        }
+    }
+    reduceRange(eu, ev, ew, i, numEdges, comp, best);
+}
+#endif
+
+using CheapestEdgesFn = void (*)(const int*, const int*, const int*, size_t, const int*, uint64_t*);
+
+struct KernelChoice {
+    CheapestEdgesFn fn;
+    const char* name;
+};
+
+static KernelChoice selectKernel() {
+#ifdef BORUVKA_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {cheapestEdgesAVX512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {cheapestEdgesAVX2, "avx2"};
+    }
+#endif
+    return {cheapestEdgesScalar, "scalar"};
+}
+
+static const KernelChoice& kernel() {
+    static const KernelChoice choice = selectKernel();
+    return choice;
+}
+
+void cheapestEdges(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best) {
+    kernel().fn(eu, ev, ew, numEdges, comp, best);
+}
+
+const char* cheapestEdgesKernel() {
+    return kernel().name;
+}
@@ -0,0 +1,32 @@
+#ifndef BORUVKA_KERNELS_HPP
+#define BORUVKA_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Cheapest-edge reduction of one Borůvka round.
+// The edges are stored as structure-of-arrays (eu[i], ev[i], ew[i]) and comp[v] is the
+// precomputed component label of vertex v, so the kernel does no find() calls and no
+// data-dependent compares: for every edge whose endpoints lie in different components,
+//      best[comp[u]] = min(best[comp[u]], key)   and   best[comp[v]] = min(best[comp[v]], key)
+// where key = packEdgeKey(weight, edge index). best must be filled with UINT64_MAX by the caller.
+//
+// The implementation is picked once at runtime: AVX-512, AVX2 or the scalar fallback.
+void cheapestEdges(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best);
+
+// Portable version, also used for the tail of the vectorized kernels
+void cheapestEdgesScalar(const int* eu, const int* ev, const int* ew, size_t numEdges, const int* comp, uint64_t* best);
+
+// Name of the kernel selected by the CPU dispatch ("avx512", "avx2" or "scalar")
+const char* cheapestEdgesKernel();
+
+// Orders edges by weight, ties broken by index, so the reduction is a plain unsigned min
+inline uint64_t packEdgeKey(int weight, uint32_t index) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(weight) ^ 0x80000000u) << 32) | index;
+}
+
+inline uint32_t edgeKeyIndex(uint64_t key) {
+    return static_cast<uint32_t>(key);
+}
+
+#endif // BORUVKA_KERNELS_HPP
@@ -0,0 +1,138 @@
+#include "Bottleneck.hpp"
+#include "MSTSolver.hpp"
+#include <algorithm>
+
+// Edge of the current (contracted) level: endpoints are labels of that level, index points to
+// the original edge
+struct LevelEdge {
+    int u, v, weight;
+    size_t index;
+};
+
+std::vector<Edge> bottleneckSpanningTree(const Graph& graph) {
+    std::vector<Edge> original;
+    for (const Edge& edge : graph.getEdges()) {
+        if (edge.u < edge.v) {
+            original.push_back(edge);
+        }
+    }
+
+    std::vector<LevelEdge> edges;
+    edges.reserve(original.size());
+    for (size_t i = 0; i < original.size(); ++i) {
+        edges.push_back({original[i].u, original[i].v, original[i].weight, i});
+    }
+
+    std::vector<Edge> tree;
+    int n = graph.getNumVertices();
+    std::vector<int> parent, rank, label;
+
+    // Camerini: split the edges at the median weight. If the lighter half connects the graph the
+    // bottleneck is in it, so continue with that half only. Otherwise its spanning forest belongs to
+    // the answer, contract the forest's components and continue with the heavier half.
+    // Every level at least halves the edges, so the total work is linear.
+    while (n > 1) {
+        if (edges.empty()) {
+            return {};      // not connected
+        }
+        if (edges.size() == 1) {
+            if (n != 2) {
+                return {};
+            }
+            tree.push_back(original[edges[0].index]);
+            break;
+        }
+
+        size_t mid = (edges.size() - 1) / 2;
+        std::nth_element(edges.begin(), edges.begin() + mid, edges.end(), [](const LevelEdge& a, const LevelEdge& b) {
+            return a.weight < b.weight;
+        });
+
+        // Spanning forest of the lighter half edges[0..mid]
+        parent.resize(n);
+        rank.assign(n, 0);
+        for (int i = 0; i < n; ++i) {
+            parent[i] = i;
+        }
+        std::vector<size_t> forest;
+        for (size_t i = 0; i <= mid; ++i) {
+            int setU = find(parent, edges[i].u);
+            int setV = find(parent, edges[i].v);
+            if (setU != setV) {
+                unionSets(parent, rank, setU, setV);
+                forest.push_back(i);
+            }
+        }
+
+        if (static_cast<int>(forest.size()) == n - 1) {
+            edges.resize(mid + 1);
+            continue;
+        }
+
+        for (size_t i : forest) {
+            tree.push_back(original[edges[i].index]);
+        }
+
+        // Contract: relabel the components 0..k-1 and keep the heavier edges between components
+        label.assign(n, -1);
+        int numComponents = 0;
+        for (int i = 0; i < n; ++i) {
+            int r = find(parent, i);
+            if (label[r] == -1) {
+                label[r] = numComponents++;
+            }
+            label[i] = label[r];
+        }
+        std::vector<LevelEdge> heavier;
+        heavier.reserve(edges.size() - mid - 1);
+        for (size_t i = mid + 1; i < edges.size(); ++i) {
+            int u = label[edges[i].u];
+            int v = label[edges[i].v];
+            if (u != v) {
+                heavier.push_back({u, v, edges[i].weight, edges[i].index});
+            }
+        }
+        edges.swap(heavier);
+        n = numComponents;
+    }
+    return tree;
+}
+
+int bottleneckWeight(const std::vector<Edge>& tree) {
+    if (tree.empty()) {
+        return 0;
+    }
+    int bottleneck = tree[0].weight;
+    for (const Edge& edge : tree) {
+        bottleneck = std::max(bottleneck, edge.weight);
+    }
+    return bottleneck;
+}
+
+// ---------------------------- Minimax queries ----------------------------
+MinimaxIndex::MinimaxIndex(const Dendrogram& dendrogram)
+    : num_vertices(dendrogram.getNumVertices()), lcaIndex(dendrogram.getParents()) {
+    for (const DendrogramMerge& merge : dendrogram.getMerges()) {
+        mergeWeight.push_back(merge.weight);
+    }
+}
+
+bool MinimaxIndex::query(int u, int v, int& weight) const {
+    if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
+        return false;
+    }
+    if (u == v) {
+        weight = 0;
+        return true;
+    }
+    int ancestor = lcaIndex.lca(u, v);
+    if (ancestor == -1) {
+        return false;
+    }
+    weight = mergeWeight[ancestor - num_vertices];
+    return true;
+}
+
+size_t MinimaxIndex::memoryUsage() const {
+    return sizeof(MinimaxIndex) - sizeof(LCAIndex) + lcaIndex.memoryUsage() + mergeWeight.capacity() * sizeof(int);
+}
@@ -0,0 +1,37 @@
+#ifndef BOTTLENECK_HPP
+#define BOTTLENECK_HPP
+
+#include <vector>
+#include "Graph.hpp"
+#include "MSTClustering.hpp"
+#include "LCAIndex.hpp"
+
+// Minimum bottleneck spanning tree with Camerini's median-splitting algorithm, O(E) expected
+// (plus the inverse Ackermann of the DSU). The result is a spanning tree whose heaviest edge is
+// as light as possible; it is not necessarily a minimum spanning tree.
+// Returns an empty vector if the graph is not connected.
+std::vector<Edge> bottleneckSpanningTree(const Graph& graph);
+
+// Heaviest edge of a spanning tree (the bottleneck), 0 for an empty tree
+int bottleneckWeight(const std::vector<Edge>& tree);
+
+// Minimax path queries: the smallest possible "heaviest edge" over all paths between two
+// vertices. The single-linkage dendrogram is the Kruskal reconstruction tree of the graph, so the
+// answer is the merge weight of the lowest common ancestor of u and v, found in O(1).
+class MinimaxIndex {
+private:
+    int num_vertices;
+    std::vector<int> mergeWeight;   // weight of every internal dendrogram node
+    LCAIndex lcaIndex;
+
+public:
+    MinimaxIndex(const Dendrogram& dendrogram);
+
+    // false if u and v are not connected, weight is 0 for u == v
+    bool query(int u, int v, int& weight) const;
+
+    // Estimated heap and object size, for memory quotas
+    size_t memoryUsage() const;
+};
+
+#endif // BOTTLENECK_HPP
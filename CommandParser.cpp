@@ -0,0 +1,90 @@
+#include "CommandParser.hpp"
+#include <array>
+#include <charconv>
+
+struct CommandName {
+    std::string_view name;
+    CommandId id;
+};
+
+static constexpr CommandName COMMANDS[] = {
+    {"Newgraph", CMD_NEWGRAPH}, {"Newedge", CMD_NEWEDGE}, {"Removeedge", CMD_REMOVEEDGE}, {"Boruvka", CMD_BORUVKA},
+    {"Prim", CMD_PRIM}, {"Kruskal", CMD_KRUSKAL}, {"Batch", CMD_BATCH}, {"Bottleneck", CMD_BOTTLENECK},
+    {"Minimax", CMD_MINIMAX}, {"Path", CMD_PATH}, {"Clusters", CMD_CLUSTERS}, {"Cut", CMD_CUT},
+    {"Sample", CMD_SAMPLE}, {"Stats", CMD_STATS}, {"Use", CMD_USE}, {"Dropgraph", CMD_DROPGRAPH}, {"Submit", CMD_SUBMIT},
+    {"Status", CMD_STATUS}, {"Result", CMD_RESULT}
+};
+
+static constexpr size_t COMMAND_TABLE_SIZE = 32;
+
+static constexpr size_t commandSlot(std::string_view name) {
+    return (name.size() + 11 * static_cast<unsigned char>(name.front()) + 25 * static_cast<unsigned char>(name.back()))
+         % COMMAND_TABLE_SIZE;
+}
+
+// Slot -> command, built at compile time. Unused slots hold CMD_UNKNOWN
+static constexpr std::array<CommandName, COMMAND_TABLE_SIZE> buildCommandTable() {
+    std::array<CommandName, COMMAND_TABLE_SIZE> table{};
+    for (const CommandName& command : COMMANDS) {
+        table[commandSlot(command.name)] = command;
+    }
+    return table;
+}
+
+static constexpr std::array<CommandName, COMMAND_TABLE_SIZE> COMMAND_TABLE = buildCommandTable();
+
+static constexpr bool commandTableIsPerfect() {
+    for (const CommandName& command : COMMANDS) {
+        if (COMMAND_TABLE[commandSlot(command.name)].id != command.id) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(commandTableIsPerfect(), "two commands share a slot, change the constants of commandSlot");
+
+CommandId commandId(std::string_view name) {
+    if (name.empty()) {
+        return CMD_UNKNOWN;
+    }
+    const CommandName& candidate = COMMAND_TABLE[commandSlot(name)];
+    return candidate.name == name ? candidate.id : CMD_UNKNOWN;
+}
+
+bool parseInt(std::string_view token, int& value) {
+    const char* begin = token.data();
+    const char* end = begin + token.size();
+    if (begin != end && *begin == '+' && end - begin > 1 && begin[1] != '-') {
+        begin++;
+    }
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// ---------------------------- Tokenizer ----------------------------
+Tokenizer::Tokenizer(std::string_view text) : text(text), pos(0) {}
+
+bool Tokenizer::next(std::string_view& token) {
+    while (pos < text.size() && isSpace(text[pos])) {
+        pos++;
+    }
+    if (pos == text.size()) {
+        return false;
+    }
+    size_t begin = pos;
+    while (pos < text.size() && !isSpace(text[pos])) {
+        pos++;
+    }
+    token = text.substr(begin, pos - begin);
+    return true;
+}
+
+bool Tokenizer::nextInt(int& value) {
+    std::string_view token;
+    return next(token) && parseInt(token, value);
+}
+
+std::string_view Tokenizer::rest() const {
+    return text.substr(pos);
+}
@@ -0,0 +1,63 @@
+#ifndef COMMAND_PARSER_HPP
+#define COMMAND_PARSER_HPP
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Commands of the text protocol
+enum CommandId : uint8_t {
+    CMD_UNKNOWN,
+    CMD_NEWGRAPH,
+    CMD_NEWEDGE,
+    CMD_REMOVEEDGE,
+    CMD_BORUVKA,
+    CMD_PRIM,
+    CMD_KRUSKAL,
+    CMD_BATCH,
+    CMD_BOTTLENECK,
+    CMD_MINIMAX,
+    CMD_PATH,
+    CMD_CLUSTERS,
+    CMD_CUT,
+    CMD_SAMPLE,
+    CMD_STATS,
+    CMD_USE,
+    CMD_DROPGRAPH,
+    CMD_SUBMIT,
+    CMD_STATUS,
+    CMD_RESULT
+};
+
+// The command with the given name, CMD_UNKNOWN if there is none. A perfect hash of the length and
+// the first and last characters picks the only candidate, one comparison confirms it
+CommandId commandId(std::string_view name);
+
+// The same whitespace as std::isspace in the "C" locale, without the locale lookup
+inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Parse a whole token as an int with std::from_chars (a leading '+' is allowed, as with operator>>).
+// False if the token is empty, has anything but digits after the sign or does not fit an int
+bool parseInt(std::string_view token, int& value);
+
+// Splits a command into whitespace separated tokens. Tokens are views into the command, nothing is
+// copied or allocated, so the command must outlive them
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view text);
+
+    // The next token, false at the end of the text
+    bool next(std::string_view& token);
+    // The next token as an int, false at the end of the text or if it is not an int (consumed anyway)
+    bool nextInt(int& value);
+    // Everything after the tokens taken so far
+    std::string_view rest() const;
+
+private:
+    std::string_view text;
+    size_t pos;
+};
+
+#endif // COMMAND_PARSER_HPP
@@ -0,0 +1,214 @@
+#include "DistanceSampling.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <queue>
+#include <climits>
+#include <cmath>
+
+// two-sided 95%
+static const double Z_95 = 1.96;
+
+GraphCSR::GraphCSR(const Graph& graph) : num_vertices(graph.getNumVertices()) {
+    // getEdges() lists every undirected edge once from each end, grouped by vertex
+    std::vector<Edge> arcs = graph.getEdges();
+    start.assign(num_vertices + 1, 0);
+    for (const Edge& arc : arcs) {
+        start[arc.u + 1]++;
+    }
+    for (int v = 0; v < num_vertices; ++v) {
+        start[v + 1] += start[v];
+    }
+    neighbor.resize(arcs.size());
+    weight.resize(arcs.size());
+    std::vector<int> fillPos(start.begin(), start.end() - 1);
+    for (const Edge& arc : arcs) {
+        neighbor[fillPos[arc.u]] = arc.v;
+        weight[fillPos[arc.u]++] = arc.weight;
+    }
+}
+
+// What one source contributes
+struct SourceResult {
+    double distanceSum = 0;
+    long long reachable = 0;        // targets other than the source itself
+    std::vector<long long> targetDistances;     // reachable sampled targets, sorted
+};
+
+// k distinct random vertices (partial Fisher-Yates)
+static std::vector<int> pickVertices(int n, int k, std::mt19937& rng) {
+    std::vector<int> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    for (int i = 0; i < k; ++i) {
+        std::uniform_int_distribution<int> pick(i, n - 1);
+        std::swap(ids[i], ids[pick(rng)]);
+    }
+    ids.resize(k);
+    return ids;
+}
+
+// Nearest-rank quantile of a sorted sample
+static long long quantileOf(const std::vector<long long>& sorted, double q) {
+    long long rank = static_cast<long long>(std::ceil(q * sorted.size())) - 1;
+    rank = std::max(0LL, std::min(rank, static_cast<long long>(sorted.size()) - 1));
+    return sorted[rank];
+}
+
+// Standard error of the ratio sum(numerator) / sum(denominator) when the sources are the sampled
+// units (linearized ratio estimator with the finite population correction)
+static double ratioStandardError(const std::vector<double>& numerator, const std::vector<double>& denominator,
+                                 int numVertices) {
+    size_t k = numerator.size();
+    if (k < 2) {
+        return 0;
+    }
+    double numeratorTotal = std::accumulate(numerator.begin(), numerator.end(), 0.0);
+    double denominatorTotal = std::accumulate(denominator.begin(), denominator.end(), 0.0);
+    if (denominatorTotal == 0) {
+        return 0;
+    }
+    double ratio = numeratorTotal / denominatorTotal;
+    double squares = 0;
+    for (size_t s = 0; s < k; ++s) {
+        double residual = numerator[s] - ratio * denominator[s];
+        squares += residual * residual;
+    }
+    double meanDenominator = denominatorTotal / k;
+    double correction = 1.0 - static_cast<double>(k) / numVertices;
+    return std::sqrt(correction * squares / (k * (k - 1.0))) / meanDenominator;
+}
+
+// Pooled percentile with Woodruff's interval: the interval of the fraction of pairs at or below the
+// estimate, mapped back through the pooled distribution
+static DistanceEstimate percentile(const std::vector<SourceResult>& results, const std::vector<long long>& pooled,
+                                   double q, int numVertices) {
+    DistanceEstimate estimate;
+    long long value = quantileOf(pooled, q);
+    std::vector<double> below, sampled;
+    for (const SourceResult& result : results) {
+        const std::vector<long long>& distances = result.targetDistances;
+        below.push_back(std::upper_bound(distances.begin(), distances.end(), value) - distances.begin());
+        sampled.push_back(distances.size());
+    }
+    double margin = Z_95 * ratioStandardError(below, sampled, numVertices);
+    estimate.value = value;
+    estimate.low = quantileOf(pooled, std::max(0.0, q - margin));
+    estimate.high = quantileOf(pooled, std::min(1.0, q + margin));
+    return estimate;
+}
+
+bool sampleDistances(const GraphCSR& graph, int numSources, unsigned seed, DistanceSample& result, ThreadPool& pool,
+                     int maxDistances) {
+    int n = graph.num_vertices;
+    if (n < 2 || numSources < 1) {
+        return false;
+    }
+    for (int w : graph.weight) {
+        if (w < 0) {
+            return false;       // Dijkstra needs non-negative weights
+        }
+    }
+
+    // every vertex as a source is exact already; past the budget, fewer sources and wider intervals
+    int numTargets = std::min(n, MAX_SAMPLE_TARGETS);
+    int requested = std::min(numSources, n);
+    int k = std::min(requested, std::max(1, maxDistances / numTargets));
+    std::mt19937 rng(seed);
+    std::vector<int> sources = pickVertices(n, k, rng);
+    std::vector<int> targets = pickVertices(n, numTargets, rng);
+
+    std::vector<SourceResult> results(k);
+    pool.parallelFor(k, [&](size_t begin, size_t end) {
+        // distances are reset through the touched list, one O(V) allocation per chunk
+        std::vector<long long> distance(n, LLONG_MAX);
+        std::vector<int> touched;
+        typedef std::pair<long long, int> QueueEntry;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        for (size_t s = begin; s < end; ++s) {
+            int source = sources[s];
+            distance[source] = 0;
+            touched.push_back(source);
+            queue.push({0, source});
+            SourceResult& sourceResult = results[s];
+            while (!queue.empty()) {
+                QueueEntry top = queue.top();
+                queue.pop();
+                int u = top.second;
+                if (top.first > distance[u]) {
+                    continue;       // stale entry
+                }
+                if (u != source) {
+                    sourceResult.distanceSum += top.first;
+                    sourceResult.reachable++;
+                }
+                for (int i = graph.start[u]; i < graph.start[u + 1]; ++i) {
+                    int v = graph.neighbor[i];
+                    long long candidate = top.first + graph.weight[i];
+                    if (candidate < distance[v]) {
+                        if (distance[v] == LLONG_MAX) {
+                            touched.push_back(v);
+                        }
+                        distance[v] = candidate;
+                        queue.push({candidate, v});
+                    }
+                }
+            }
+            for (int target : targets) {
+                if (target != source && distance[target] != LLONG_MAX) {
+                    sourceResult.targetDistances.push_back(distance[target]);
+                }
+            }
+            std::sort(sourceResult.targetDistances.begin(), sourceResult.targetDistances.end());
+            for (int v : touched) {
+                distance[v] = LLONG_MAX;
+            }
+            touched.clear();
+        }
+    });
+
+    result = DistanceSample();
+    result.numSources = k;
+    result.requestedSources = requested;
+    std::vector<double> sums, counts;
+    std::vector<long long> pooled;
+    for (const SourceResult& sourceResult : results) {
+        result.numPairs += sourceResult.reachable;
+        result.unreachablePairs += n - 1 - sourceResult.reachable;
+        sums.push_back(sourceResult.distanceSum);
+        counts.push_back(sourceResult.reachable);
+        pooled.insert(pooled.end(), sourceResult.targetDistances.begin(), sourceResult.targetDistances.end());
+    }
+    if (result.numPairs == 0) {
+        return true;
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double mean = std::accumulate(sums.begin(), sums.end(), 0.0) / result.numPairs;
+    double margin = Z_95 * ratioStandardError(sums, counts, n);
+    result.mean.value = mean;
+    result.mean.low = mean - margin;
+    result.mean.high = mean + margin;
+    result.median = percentile(results, pooled, 0.5, n);
+    result.p99 = percentile(results, pooled, 0.99, n);
+    return true;
+}
+
+static std::string printEstimate(const std::string& name, const DistanceEstimate& estimate) {
+    return name + ": " + std::to_string(estimate.value) + " (95% CI " + std::to_string(estimate.low) + " - "
+        + std::to_string(estimate.high) + ")\n";
+}
+
+std::string printDistanceSample(const DistanceSample& sample) {
+    std::string response = "Distance sample: " + std::to_string(sample.numSources) + " sources";
+    if (sample.requestedSources > sample.numSources) {
+        response += " (capped from " + std::to_string(sample.requestedSources) + " by the memory budget)";
+    }
+    response += ", " + std::to_string(sample.numPairs) + " reachable pairs, " + std::to_string(sample.unreachablePairs) + " unreachable\n";
+    if (sample.numPairs == 0) {
+        return response;
+    }
+    response += printEstimate("Mean distance", sample.mean);
+    response += printEstimate("Median distance", sample.median);
+    response += printEstimate("99th percentile", sample.p99);
+    return response;
+}
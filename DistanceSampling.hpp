@@ -0,0 +1,56 @@
+#ifndef DISTANCE_SAMPLING_HPP
+#define DISTANCE_SAMPLING_HPP
+
+#include <vector>
+#include <string>
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+
+// Read-only CSR copy of a Graph: taken under the graph lock, then searched without it
+struct GraphCSR {
+    int num_vertices;
+    std::vector<int> start;         // neighbors of v are at [start[v], start[v + 1])
+    std::vector<int> neighbor;
+    std::vector<int> weight;
+
+    GraphCSR(const Graph& graph);
+};
+
+// Every source keeps its distances to at most this many fixed random targets for the percentiles
+// (the mean uses all of its distances), so memory stays O(sources * targets) on huge graphs
+const int MAX_SAMPLE_TARGETS = 4096;
+// Sampled distances kept at once (sources * targets, held twice: per source and pooled). A request
+// for more sources is served with as many as fit, and says so
+const int MAX_SAMPLE_DISTANCES = 1 << 22;
+
+// Estimate with its 95% confidence interval
+struct DistanceEstimate {
+    double value = 0;
+    double low = 0;
+    double high = 0;
+};
+
+struct DistanceSample {
+    int numSources = 0;
+    int requestedSources = 0;           // above numSources when MAX_SAMPLE_DISTANCES capped them
+    long long numPairs = 0;             // reachable (source, target) pairs behind the mean
+    long long unreachablePairs = 0;
+    DistanceEstimate mean;
+    DistanceEstimate median;
+    DistanceEstimate p99;
+};
+
+// Shortest-path distance statistics over all vertex pairs, estimated from Dijkstra runs on
+// numSources random sources (without replacement), spread over the pool. More sources means
+// narrower intervals: the sources are the sampling units, so the intervals come from the spread
+// between sources (ratio estimator for the mean, Woodruff's method for the percentiles), with the
+// finite population correction (sampling every vertex gives the exact values).
+// Unreachable pairs are counted apart. At most maxDistances / targets sources are run. Returns false for negative weights or fewer than 2 vertices.
+// Must not be called from inside a task of the same pool.
+bool sampleDistances(const GraphCSR& graph, int numSources, unsigned seed, DistanceSample& result,
+                     ThreadPool& pool = computePool(), int maxDistances = MAX_SAMPLE_DISTANCES);
+
+// Text block sent to the clients
+std::string printDistanceSample(const DistanceSample& sample);
+
+#endif // DISTANCE_SAMPLING_HPP
@@ -0,0 +1,340 @@
+#include "DynamicTreeMetrics.hpp"
+#include "TreeMetrics.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+static const std::pair<long long, int> NO_VERTEX(LLONG_MIN / 4, -1);
+
+DynamicTreeMetrics::DynamicTreeMetrics(int num_vertices, const std::vector<Edge>& tree)
+    : num_vertices(std::max(num_vertices, 0)), numTreeEdges(0), numNegativeEdges(0), weightSum(0), wienerIndex(0),
+      treeDiameter(0) {
+    nodes.resize(this->num_vertices);
+    edgeEnds.assign(this->num_vertices, std::make_pair(-1, -1));
+    for (int v = 0; v < this->num_vertices; ++v) {
+        nodes[v].count = 1;
+        update(v);
+    }
+    for (const Edge& edge : tree) {
+        if (edge.u < 0 || edge.u >= this->num_vertices || edge.v < 0 || edge.v >= this->num_vertices
+            || connected(edge.u, edge.v)) {
+            continue;
+        }
+        int e = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+        nodes[e].length = edge.weight;
+        update(e);
+        edgeEnds.push_back(std::make_pair(edge.u, edge.v));
+        edgeNode[std::make_pair(std::min(edge.u, edge.v), std::max(edge.u, edge.v))] = e;
+        link(edge.u, e);
+        link(e, edge.v);
+        numTreeEdges++;
+        numNegativeEdges += edge.weight < 0;
+        weightSum += edge.weight;
+    }
+    if (isTree() && this->num_vertices > 1) {
+        MetricsResult metrics = computeMetrics(getEdges(), SIZE_MAX);
+        wienerIndex = metrics.pairwiseDistanceSum;
+        treeDiameter = metrics.diameter;
+    }
+}
+
+bool DynamicTreeMetrics::isTree() const {
+    return num_vertices > 0 && numTreeEdges == num_vertices - 1;
+}
+
+int DynamicTreeMetrics::getNumVertices() const {
+    return num_vertices;
+}
+
+long long DynamicTreeMetrics::totalWeight() const {
+    return weightSum;
+}
+
+long long DynamicTreeMetrics::pairwiseDistanceSum() const {
+    return wienerIndex;
+}
+
+long long DynamicTreeMetrics::diameter() const {
+    return treeDiameter;
+}
+
+double DynamicTreeMetrics::averageDistance() const {
+    long long n = num_vertices;
+    return n == 0 ? 0 : static_cast<double>(wienerIndex) / (n * (n + 1) / 2);
+}
+
+std::vector<Edge> DynamicTreeMetrics::getEdges() const {
+    std::vector<Edge> edges;
+    edges.reserve(numTreeEdges);
+    for (const auto& entry : edgeNode) {
+        const std::pair<int, int>& ends = edgeEnds[entry.second];
+        edges.push_back(Edge(ends.first, ends.second, static_cast<int>(nodes[entry.second].length)));
+    }
+    return edges;
+}
+
+// ---------------------------- Link-cut tree ----------------------------
+bool DynamicTreeMetrics::isSplayRoot(int x) const {
+    int p = nodes[x].parent;
+    return p == -1 || (nodes[p].left != x && nodes[p].right != x);
+}
+
+// Reverse the path segment of x: the aggregates stay exact, the children are flipped lazily
+void DynamicTreeMetrics::applyFlip(int x) {
+    Node& node = nodes[x];
+    std::swap(node.left, node.right);
+    std::swap(node.distTop, node.distBottom);
+    std::swap(node.maxTop, node.maxBottom);
+    node.flip = !node.flip;
+}
+
+void DynamicTreeMetrics::push(int x) {
+    if (nodes[x].flip) {
+        if (nodes[x].left != -1) {
+            applyFlip(nodes[x].left);
+        }
+        if (nodes[x].right != -1) {
+            applyFlip(nodes[x].right);
+        }
+        nodes[x].flip = false;
+    }
+}
+
+void DynamicTreeMetrics::update(int x) {
+    Node& node = nodes[x];
+    static const Node empty = [] {
+        Node none;
+        none.maxTop = none.maxBottom = NO_VERTEX;
+        return none;
+    }();
+    const Node& l = node.left != -1 ? nodes[node.left] : empty;
+    const Node& r = node.right != -1 ? nodes[node.right] : empty;
+
+    // vertices reached through x coming from the top (x, its virtual subtrees and the lower part),
+    // and coming from the bottom
+    long long fromTop = node.count + node.virtualSize + r.size;
+    long long fromBottom = node.count + node.virtualSize + l.size;
+    long long toX = l.sum + node.length;        // from the top of the segment through x
+    long long toXBottom = r.sum + node.length;  // from the bottom through x
+
+    node.sum = l.sum + node.length + r.sum;
+    node.size = l.size + node.count + node.virtualSize + r.size;
+    node.distTop = l.distTop + toX * fromTop + node.virtualDist + r.distTop;
+    node.distBottom = r.distBottom + toXBottom * fromBottom + node.virtualDist + l.distBottom;
+
+    Farthest virtualFarthest = node.virtualMax.empty() ? NO_VERTEX : *node.virtualMax.rbegin();
+    Farthest own = node.count ? Farthest(0, x) : NO_VERTEX;
+    node.maxTop = l.maxTop;
+    node.maxBottom = r.maxBottom;
+    for (const Farthest& candidate : {own, virtualFarthest}) {
+        if (candidate.second != -1) {
+            node.maxTop = std::max(node.maxTop, Farthest(toX + candidate.first, candidate.second));
+            node.maxBottom = std::max(node.maxBottom, Farthest(toXBottom + candidate.first, candidate.second));
+        }
+    }
+    if (r.maxTop.second != -1) {
+        node.maxTop = std::max(node.maxTop, Farthest(toX + r.maxTop.first, r.maxTop.second));
+    }
+    if (l.maxBottom.second != -1) {
+        node.maxBottom = std::max(node.maxBottom, Farthest(toXBottom + l.maxBottom.first, l.maxBottom.second));
+    }
+}
+
+void DynamicTreeMetrics::rotate(int x) {
+    int p = nodes[x].parent;
+    int g = nodes[p].parent;
+    bool parentWasRoot = isSplayRoot(p);
+    if (nodes[p].left == x) {
+        nodes[p].left = nodes[x].right;
+        if (nodes[x].right != -1) {
+            nodes[nodes[x].right].parent = p;
+        }
+        nodes[x].right = p;
+    } else {
+        nodes[p].right = nodes[x].left;
+        if (nodes[x].left != -1) {
+            nodes[nodes[x].left].parent = p;
+        }
+        nodes[x].left = p;
+    }
+    nodes[p].parent = x;
+    nodes[x].parent = g;    // keeps the path parent when p was the root
+    if (!parentWasRoot) {
+        if (nodes[g].left == p) {
+            nodes[g].left = x;
+        } else {
+            nodes[g].right = x;
+        }
+    }
+    update(p);
+    update(x);
+}
+
+void DynamicTreeMetrics::splay(int x) {
+    // push the pending flips from the root of the splay tree down to x first
+    splayPath.clear();
+    for (int y = x;; y = nodes[y].parent) {
+        splayPath.push_back(y);
+        if (isSplayRoot(y)) {
+            break;
+        }
+    }
+    for (size_t i = splayPath.size(); i-- > 0;) {
+        push(splayPath[i]);
+    }
+    while (!isSplayRoot(x)) {
+        int p = nodes[x].parent;
+        if (!isSplayRoot(p)) {
+            int g = nodes[p].parent;
+            bool zigZig = (nodes[g].left == p) == (nodes[p].left == x);
+            rotate(zigZig ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+// Make the path from the root to x preferred. The old lower part of every path on the way becomes
+// a virtual child, the path coming from below stops being one
+void DynamicTreeMetrics::access(int x) {
+    int last = -1;
+    for (int y = x; y != -1; y = nodes[y].parent) {
+        splay(y);
+        Node& node = nodes[y];
+        if (node.right != -1) {
+            const Node& lower = nodes[node.right];
+            node.virtualSize += lower.size;
+            node.virtualDist += lower.distTop;
+            node.virtualMax.insert(lower.maxTop);
+        }
+        if (last != -1) {
+            // same vertex set and the same top as when it was added, so the same values
+            const Node& upper = nodes[last];
+            node.virtualSize -= upper.size;
+            node.virtualDist -= upper.distTop;
+            node.virtualMax.erase(node.virtualMax.find(upper.maxTop));
+        }
+        node.right = last;
+        update(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void DynamicTreeMetrics::makeRoot(int x) {
+    access(x);
+    applyFlip(x);
+}
+
+int DynamicTreeMetrics::findRoot(int x) {
+    access(x);
+    while (true) {
+        push(x);
+        if (nodes[x].left == -1) {
+            break;
+        }
+        x = nodes[x].left;
+    }
+    splay(x);
+    return x;
+}
+
+bool DynamicTreeMetrics::connected(int x, int y) {
+    if (x == y) {
+        return true;
+    }
+    makeRoot(x);
+    return findRoot(y) == x;
+}
+
+// x and y must be in different trees
+void DynamicTreeMetrics::link(int x, int y) {
+    makeRoot(x);
+    access(y);
+    nodes[x].parent = y;
+    nodes[y].virtualSize += nodes[x].size;
+    nodes[y].virtualDist += nodes[x].distTop;
+    nodes[y].virtualMax.insert(nodes[x].maxTop);
+    update(y);
+}
+
+// x and y must be adjacent
+void DynamicTreeMetrics::cut(int x, int y) {
+    makeRoot(x);
+    access(y);
+    // the path is just x -> y now, x is the left child of y
+    nodes[y].left = -1;
+    nodes[x].parent = -1;
+    update(y);
+}
+
+// ---------------------------- Queries and swaps ----------------------------
+long long DynamicTreeMetrics::distanceSum(int v) {
+    makeRoot(v);
+    return nodes[v].distTop;
+}
+
+long long DynamicTreeMetrics::eccentricity(int v, int* farthest) {
+    makeRoot(v);
+    if (farthest) {
+        *farthest = nodes[v].maxTop.second;
+    }
+    return nodes[v].maxTop.first;
+}
+
+void DynamicTreeMetrics::recomputeDiameter() {
+    if (numNegativeEdges > 0) {
+        treeDiameter = computeMetrics(getEdges(), SIZE_MAX).diameter;
+        return;
+    }
+    int end;
+    eccentricity(0, &end);
+    treeDiameter = eccentricity(end);
+}
+
+bool DynamicTreeMetrics::swapEdge(int u, int v, int x, int y, int weight) {
+    if (!isTree() || x < 0 || x >= num_vertices || y < 0 || y >= num_vertices || x == y) {
+        return false;
+    }
+    auto old = edgeNode.find(std::make_pair(std::min(u, v), std::max(u, v)));
+    if (old == edgeNode.end()) {
+        return false;
+    }
+    int e = old->second;
+    u = edgeEnds[e].first;
+    v = edgeEnds[e].second;
+
+    cut(u, e);
+    cut(e, v);
+    if (connected(x, y)) {
+        // (x, y) lies on one side, it would not reconnect the tree
+        link(u, e);
+        link(e, v);
+        return false;
+    }
+    if (!connected(x, u)) {
+        std::swap(x, y);
+    }
+
+    // remove the paths through the old edge, add the ones through the new edge
+    long long oldWeight = nodes[e].length;
+    access(u);
+    long long sizeA = nodes[u].size;
+    long long sizeB = num_vertices - sizeA;
+    wienerIndex -= oldWeight * sizeA * sizeB + sizeB * distanceSum(u) + sizeA * distanceSum(v);
+    wienerIndex += weight * sizeA * sizeB + sizeB * distanceSum(x) + sizeA * distanceSum(y);
+
+    // the isolated edge node is reused for the new edge
+    edgeNode.erase(old);
+    edgeNode[std::make_pair(std::min(x, y), std::max(x, y))] = e;
+    edgeEnds[e] = std::make_pair(x, y);
+    numNegativeEdges += (weight < 0) - (oldWeight < 0);
+    weightSum += weight - oldWeight;
+    nodes[e].length = weight;
+    update(e);
+    link(x, e);
+    link(e, y);
+
+    recomputeDiameter();
+    return true;
+}
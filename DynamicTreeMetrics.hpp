@@ -0,0 +1,109 @@
+#ifndef DYNAMIC_TREE_METRICS_HPP
+#define DYNAMIC_TREE_METRICS_HPP
+
+#include <vector>
+#include <set>
+#include <map>
+#include <utility>
+#include "Graph.hpp"
+
+// Distance metrics of a spanning tree kept up to date while the tree changes by edge swaps
+// (drop a tree edge, add an edge that reconnects the two parts), in O(log V) amortized per swap
+// instead of a full O(V) pass.
+//
+// The tree is stored in a link-cut tree where every edge is a node of its own (holding the weight)
+// between its two vertex nodes. Every splay node aggregates the part of the tree it represents -
+// its path segment plus the subtrees hanging off it ("virtual" children) - as: vertex count,
+// segment length, sum of the distances from the top and from the bottom of the segment to all of
+// its vertices, and the farthest vertex from either end. Making a vertex the root then gives its
+// distance sum and eccentricity (with the farthest vertex) in O(log V).
+//
+// Swapping (a, b) of weight w for (c, d) of weight w' splits the tree into A (with a and c) and
+// B (with b and d):
+//   W' = W - w|A||B| - |B| D(a) - |A| D(b) + w'|A||B| + |B| D(c) + |A| D(d)
+// where D(x) is the distance sum of x inside its part, and the diameter comes from a double sweep
+// (the farthest vertex from any vertex is an end of a diameter; with negative weights this does
+// not hold and the diameter is recomputed in O(V) instead).
+//
+// The servers do not use it: an MST response lists every tree edge and the metrics that need a
+// full pass anyway (radius, centers, degrees, histograms), and finding the swap for an edge
+// update (the heaviest tree edge on a path, or the lightest replacement for a removed one) is not
+// part of it. It is for callers that own a tree and only need these metrics after each swap.
+class DynamicTreeMetrics {
+public:
+    // tree must be a spanning tree of the vertices 0..num_vertices-1; edges that are out of range
+    // or close a cycle are ignored, isTree() tells whether the rest spans everything
+    DynamicTreeMetrics(int num_vertices, const std::vector<Edge>& tree);
+
+    bool isTree() const;
+    int getNumVertices() const;
+
+    // Replace the tree edge (u, v) with the edge (x, y) of the given weight. False (and no change)
+    // if (u, v) is not a tree edge or (x, y) does not reconnect the two parts, or not a tree
+    bool swapEdge(int u, int v, int x, int y, int weight);
+
+    long long totalWeight() const;
+    long long pairwiseDistanceSum() const;
+    long long diameter() const;
+    // over all pairs (i, j) with j >= i, like MetricsResult
+    double averageDistance() const;
+
+    // Sum of the distances from v to every vertex of its tree
+    long long distanceSum(int v);
+    // Longest distance from v (0 for a single vertex), and the vertex at that distance
+    long long eccentricity(int v, int* farthest = nullptr);
+
+    std::vector<Edge> getEdges() const;
+
+private:
+    typedef std::pair<long long, int> Farthest;     // (distance, vertex), the larger pair wins
+
+    struct Node {
+        int left = -1;
+        int right = -1;
+        int parent = -1;            // splay parent, or path parent for the root of a splay tree
+        bool flip = false;          // children still have to be flipped
+        long long length = 0;       // edge weight for edge nodes, 0 for vertices
+        int count = 0;              // 1 for vertices, 0 for edge nodes
+
+        // aggregates over the splay subtree and everything hanging off it
+        long long sum = 0;          // length of the path segment
+        long long size = 0;         // vertices
+        long long distTop = 0;      // sum of the distances from the top of the segment
+        long long distBottom = 0;   // ... from the bottom
+        Farthest maxTop;
+        Farthest maxBottom;
+
+        // virtual children (roots of the splay trees whose path hangs off this node)
+        long long virtualSize = 0;
+        long long virtualDist = 0;  // sum of their distTop
+        std::multiset<Farthest> virtualMax;     // their maxTop
+    };
+
+    bool isSplayRoot(int x) const;
+    void applyFlip(int x);
+    void push(int x);
+    void update(int x);
+    void rotate(int x);
+    void splay(int x);
+    void access(int x);
+    void makeRoot(int x);
+    int findRoot(int x);
+    bool connected(int x, int y);
+    void link(int x, int y);
+    void cut(int x, int y);
+    void recomputeDiameter();
+
+    int num_vertices;
+    std::vector<Node> nodes;        // 0..num_vertices-1 vertices, then one node per tree edge
+    std::map<std::pair<int, int>, int> edgeNode;    // (smaller, larger) end -> node
+    std::vector<std::pair<int, int>> edgeEnds;      // ends of every edge node
+    std::vector<int> splayPath;     // scratch for splay()
+    int numTreeEdges;
+    int numNegativeEdges;
+    long long weightSum;
+    long long wienerIndex;
+    long long treeDiameter;
+};
+
+#endif // DYNAMIC_TREE_METRICS_HPP
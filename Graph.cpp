@@ -1,9 +1,21 @@
 #include <iostream>
 #include "Graph.hpp"
 #include <stack>
+#include <atomic>
+#include <unordered_set>
+#include <cstdint>
+
+// Generations come from one counter for all graphs, so results cached for one graph never match
+// another graph
+static unsigned long long nextGeneration() {
+    static std::atomic<unsigned long long> counter(0);
+    return ++counter;
+}
 
 Graph::Graph(int num_vertices) {
     this->num_vertices = num_vertices;
+    generation = nextGeneration();
+    num_entries = 0;
     adj.resize(num_vertices);
 
     #ifdef DEBUG
@@ -20,12 +32,15 @@ void Graph::resetGraph(int num_vertices) {
     this->num_vertices = num_vertices;
     adj.clear();
     adj.resize(num_vertices);
+    generation = nextGeneration();
+    num_entries = 0;
 }
 
 void Graph::addEdge(int u, int v, int weight) {
     if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
         return;
     }
+    generation = nextGeneration();
     bool found = false;
     for (const Edge& edge : adj[u]) {
         if (edge == v) {
@@ -34,6 +49,7 @@ void Graph::addEdge(int u, int v, int weight) {
     }
     if (!found) {
         adj[u].push_back(Edge(u, v, weight));
+        num_entries++;
     }
     found = false;
     for (const Edge& edge : adj[v]) {
@@ -43,14 +59,67 @@ void Graph::addEdge(int u, int v, int weight) {
     }
     if (!found) {
         adj[v].push_back(Edge(v, u, weight));
+        num_entries++;
+    }
+}
+
+size_t Graph::addEdges(const std::vector<Edge>& edges) {
+    generation = nextGeneration();
+    std::vector<size_t> degree(num_vertices, 0);
+    for (const Edge& edge : edges) {
+        if (edge.u >= 0 && edge.u < num_vertices && edge.v >= 0 && edge.v < num_vertices) {
+            degree[edge.u]++;
+            degree[edge.v]++;
+        }
+    }
+    // the entries u->v already there, so a duplicate costs one lookup instead of a scan of adj[u]
+    auto key = [](int u, int v) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(u)) << 32) | static_cast<uint32_t>(v);
+    };
+    std::unordered_set<uint64_t> present;
+    size_t existing = 0;
+    for (int i = 0; i < num_vertices; ++i) {
+        if (degree[i] > 0) {
+            existing += adj[i].size();
+        }
     }
+    present.reserve(existing + 2 * edges.size());
+    for (int i = 0; i < num_vertices; ++i) {
+        if (degree[i] > 0) {
+            for (const Edge& entry : adj[i]) {
+                present.insert(key(i, entry.v));
+            }
+            adj[i].reserve(adj[i].size() + degree[i]);
+        }
+    }
+    size_t added = 0;
+    for (const Edge& edge : edges) {
+        if (edge.u < 0 || edge.u >= num_vertices || edge.v < 0 || edge.v >= num_vertices) {
+            continue;
+        }
+        bool isNew = false;
+        if (present.insert(key(edge.u, edge.v)).second) {
+            adj[edge.u].push_back(Edge(edge.u, edge.v, edge.weight));
+            num_entries++;
+            isNew = true;
+        }
+        if (present.insert(key(edge.v, edge.u)).second) {
+            adj[edge.v].push_back(Edge(edge.v, edge.u, edge.weight));
+            num_entries++;
+            isNew = true;
+        }
+        added += isNew;
+    }
+    return added;
 }
 
 void Graph::removeEdge(int u, int v) {
+    generation = nextGeneration();
     auto it_u = std::remove_if(adj[u].begin(), adj[u].end(), [v](const Edge& edge) {
         return edge == v;
     });
     if (it_u != adj[u].end()) {
+        num_entries -= adj[u].end() - it_u;
         adj[u].erase(it_u, adj[u].end());
     }
 
@@ -58,6 +127,7 @@ void Graph::removeEdge(int u, int v) {
         return edge == u;
     });
     if (it_v != adj[v].end()) {
+        num_entries -= adj[v].end() - it_v;
         adj[v].erase(it_v, adj[v].end());
     }
 }
@@ -81,11 +151,23 @@ Edge& Graph::getEdge(int u, int v) {
     throw std::out_of_range("Edge does not exist");
 }
 
+const Edge& Graph::getEdge(int u, int v) const {
+    for (const Edge& edge : adj[u]) {
+        if (edge.v == v) {
+            return edge;
+        }
+    }
+    throw std::out_of_range("Edge does not exist");
+}
+
 std::vector<Edge> Graph::getNeighbors(int u) const {
     return adj[u];
 }
 
-bool Graph::isConnected() {
+bool Graph::isConnected() const {
+    if (num_vertices == 0) {
+        return true;    // nothing to disconnect, and no vertex 0 to start the dfs from
+    }
     // use simple dfs, this is an undirected graph
     std::vector<bool> visited(num_vertices, false);
     DFS(0, visited);
@@ -99,18 +181,36 @@ bool Graph::isConnected() {
     return true;
 }
 
-// DFS function for a graph
-void Graph::DFS(int v, std::vector<bool>& visited) {
+// DFS function for a graph, with an explicit stack: a long path would overflow the call stack
+void Graph::DFS(int v, std::vector<bool>& visited) const {
+    std::stack<int> pending;
     visited[v] = true;
-
-    // Visit all neighbors of v
-    for (const Edge& edge : adj[v]) {
-        if (!visited[edge.v]) {
-            DFS(edge.v, visited);
+    pending.push(v);
+
+    while (!pending.empty()) {
+        int u = pending.top();
+        pending.pop();
+        // Visit all neighbors of u
+        for (const Edge& edge : adj[u]) {
+            if (!visited[edge.v]) {
+                visited[edge.v] = true;
+                pending.push(edge.v);
+            }
         }
     }
 }
 
 int Graph::getNumVertices() const {
     return num_vertices;
-}
\ No newline at end of file
+}
+unsigned long long Graph::getGeneration() const {
+    return generation;
+}
+
+size_t Graph::memoryUsage() const {
+    return sizeof(Graph) + adj.size() * sizeof(std::vector<Edge>) + num_entries * sizeof(Edge);
+}
+
+size_t Graph::memoryFor(size_t num_vertices, size_t num_edges) {
+    return sizeof(Graph) + num_vertices * sizeof(std::vector<Edge>) + 2 * num_edges * sizeof(Edge);
+}
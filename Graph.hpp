@@ -33,6 +33,8 @@ class Graph {
 private:
     int num_vertices;                     // Number of vertices in the graph
     std::vector<std::vector<Edge>> adj;  // Adjacency list for each vertex
+    unsigned long long generation;       // New by every mutation, unique across graphs, never goes back (not even on reset)
+    size_t num_entries;                  // Edges in all adjacency lists (each undirected edge twice)
     
 public:
     // Constructor to init a graph with the given number of vertices (no edges yet)
@@ -45,6 +47,12 @@ public:
     // Add an undirected edge between vertices u and v
     void addEdge(int u, int v, int weight);
 
+    // Add many undirected edges at once, the same as addEdge for each but with one new generation,
+    // the adjacency lists sized up front and duplicates found through a hash set (linear, even for
+    // a vertex of high degree). Returns the number of edges added, duplicates and edges with an end
+    // out of range left out
+    size_t addEdges(const std::vector<Edge>& edges);
+
     // Remove an edge between vertices u and v
     void removeEdge(int u, int v);
 
@@ -55,16 +63,25 @@ public:
     std::vector<Edge> getNeighbors(int u) const;
 
     Edge& getEdge(int u, int v);
+    const Edge& getEdge(int u, int v) const;
 
     // Check if the graph is connected
-    bool isConnected();
+    bool isConnected() const;
 
     // Get the number of vertices in the graph
     int getNumVertices() const;
 
+    // Version of the graph contents: results computed at the same generation are still valid
+    unsigned long long getGeneration() const;
+
+    // Estimated heap and object size of the graph, for memory quotas
+    size_t memoryUsage() const;
+    // The same estimate for a graph with the given number of vertices and undirected edges
+    static size_t memoryFor(size_t num_vertices, size_t num_edges);
+
 private:
     // Helper DFS functions to visit all vertices in undirected graph
-    void DFS(int v, std::vector<bool>& visited);
+    void DFS(int v, std::vector<bool>& visited) const;
 };
 
 
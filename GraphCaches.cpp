@@ -0,0 +1,111 @@
+#include "GraphCaches.hpp"
+#include "MSTSolver.hpp"
+
+static size_t memoryOf(const std::vector<Edge>& forest) {
+    return sizeof(forest) + forest.capacity() * sizeof(Edge);
+}
+
+template <typename T>
+static size_t memoryOf(const T& index) {
+    return index.memoryUsage();
+}
+
+GraphCaches::GraphCaches(Keep keep, Release release)
+    : keep(std::move(keep)), release(std::move(release)), keptBytes(0), cleared(false) {}
+
+// The caches for the generation of graph. The least recently used generation makes room for a
+// new one
+std::shared_ptr<GraphCaches::Generation> GraphCaches::generationOf(const Graph& graph) {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto it = generations.begin(); it != generations.end(); ++it) {
+        if ((*it)->generation == graph.getGeneration()) {
+            generations.splice(generations.begin(), generations, it);
+            return generations.front();
+        }
+    }
+    if (generations.size() == MAX_CACHED_GENERATIONS) {
+        // readers still holding it keep its structures alive, but they are not counted any more
+        std::shared_ptr<Generation> victim = generations.back();
+        generations.pop_back();
+        victim->evicted = true;
+        keptBytes -= victim->bytes;
+        if (release) {
+            release(victim->bytes);
+        }
+    }
+    generations.push_front(std::make_shared<Generation>());
+    generations.front()->generation = graph.getGeneration();
+    return generations.front();
+}
+
+// The structure of the generation, built on the first call. Kept if the quota admits it
+template <typename T, typename Build>
+std::shared_ptr<const T> GraphCaches::get(Generation& generation, Lazy<T>& lazy, Build build) {
+    std::lock_guard<std::mutex> building(lazy.building);
+    if (lazy.value) {
+        return lazy.value;
+    }
+    std::shared_ptr<const T> value = build();
+    size_t size = memoryOf(*value);
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!generation.evicted && !cleared && (!keep || keep(size))) {
+        generation.bytes += size;
+        keptBytes += size;
+        lazy.value = value;
+    }
+    return value;
+}
+
+// A forest rather than the MST of the MST commands: a disconnected graph has no spanning tree, but
+// its components still have clusters, minimax weights and paths
+std::shared_ptr<const std::vector<Edge>> GraphCaches::forest(const Graph& graph, Generation& generation) {
+    return get(generation, generation.forest, [&] {
+        return std::make_shared<const std::vector<Edge>>(ParallelKruskalSolver().spanningForest(graph));
+    });
+}
+
+std::shared_ptr<const Dendrogram> GraphCaches::dendrogram(const Graph& graph, Generation& generation) {
+    return get(generation, generation.dendrogram, [&] {
+        return std::make_shared<const Dendrogram>(graph.getNumVertices(), *forest(graph, generation));
+    });
+}
+
+std::shared_ptr<const std::vector<Edge>> GraphCaches::forest(const Graph& graph) {
+    return forest(graph, *generationOf(graph));
+}
+
+std::shared_ptr<const Dendrogram> GraphCaches::dendrogram(const Graph& graph) {
+    return dendrogram(graph, *generationOf(graph));
+}
+
+std::shared_ptr<const TreePathIndex> GraphCaches::pathIndex(const Graph& graph) {
+    std::shared_ptr<Generation> generation = generationOf(graph);
+    return get(*generation, generation->pathIndex, [&] {
+        return std::make_shared<const TreePathIndex>(graph.getNumVertices(), *forest(graph, *generation));
+    });
+}
+
+std::shared_ptr<const MinimaxIndex> GraphCaches::minimaxIndex(const Graph& graph) {
+    std::shared_ptr<Generation> generation = generationOf(graph);
+    return get(*generation, generation->minimax, [&] {
+        return std::make_shared<const MinimaxIndex>(*dendrogram(graph, *generation));
+    });
+}
+
+void GraphCaches::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const std::shared_ptr<Generation>& generation : generations) {
+        generation->evicted = true;
+    }
+    generations.clear();
+    if (release) {
+        release(keptBytes);
+    }
+    keptBytes = 0;
+    cleared = true;
+}
+
+size_t GraphCaches::bytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return keptBytes;
+}
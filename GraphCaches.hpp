@@ -0,0 +1,78 @@
+#ifndef GRAPH_CACHES_HPP
+#define GRAPH_CACHES_HPP
+
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include "Graph.hpp"
+#include "MSTClustering.hpp"
+#include "Bottleneck.hpp"
+#include "TreePathIndex.hpp"
+
+// Generations of one graph whose query structures are kept: the newest, and the one before it for
+// the readers still on an older snapshot
+const size_t MAX_CACHED_GENERATIONS = 2;
+
+// The query structures (Clusters, Cut, Minimax, Path) of one graph, per generation. Every graph of
+// the registry has its own, behind a lock of its own that only guards the list of generations:
+// the structures are built outside it, so queries of other graphs and generations never wait for
+// a build, and the queries that need the same structure wait for its one build.
+//
+// A built structure is kept only if keep admits its bytes (the graph's memory quota, see
+// GraphRegistry); otherwise the query that built it uses it and drops it. The bytes of a
+// generation are given back through release when it is evicted or the caches are cleared.
+class GraphCaches {
+public:
+    typedef std::function<bool(size_t bytes)> Keep;
+    typedef std::function<void(size_t bytes)> Release;
+
+    // Without callbacks every structure is kept
+    GraphCaches(Keep keep = nullptr, Release release = nullptr);
+
+    // graph is a snapshot of the graph the caches belong to
+    std::shared_ptr<const std::vector<Edge>> forest(const Graph& graph);
+    std::shared_ptr<const Dendrogram> dendrogram(const Graph& graph);
+    std::shared_ptr<const TreePathIndex> pathIndex(const Graph& graph);
+    std::shared_ptr<const MinimaxIndex> minimaxIndex(const Graph& graph);
+
+    // Drop every generation and release its bytes; structures built later are not kept
+    void clear();
+    // Bytes kept
+    size_t bytes() const;
+
+private:
+    // One structure of a generation, built by the first query that needs it
+    template <typename T>
+    struct Lazy {
+        std::mutex building;
+        std::shared_ptr<const T> value;
+    };
+
+    struct Generation {
+        unsigned long long generation;
+        bool evicted = false;
+        size_t bytes = 0;
+        Lazy<std::vector<Edge>> forest;         // minimum spanning forest the others are built from
+        Lazy<Dendrogram> dendrogram;
+        Lazy<MinimaxIndex> minimax;             // over the dendrogram (Kruskal reconstruction tree)
+        Lazy<TreePathIndex> pathIndex;          // distance / path-max index over the forest
+    };
+
+    std::shared_ptr<Generation> generationOf(const Graph& graph);
+    template <typename T, typename Build>
+    std::shared_ptr<const T> get(Generation& generation, Lazy<T>& lazy, Build build);
+
+    std::shared_ptr<const std::vector<Edge>> forest(const Graph& graph, Generation& generation);
+    std::shared_ptr<const Dendrogram> dendrogram(const Graph& graph, Generation& generation);
+
+    Keep keep;
+    Release release;
+    mutable std::mutex mtx;
+    std::list<std::shared_ptr<Generation>> generations;    // most recently used first
+    size_t keptBytes;
+    bool cleared;
+};
+
+#endif // GRAPH_CACHES_HPP
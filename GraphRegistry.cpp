@@ -0,0 +1,154 @@
+#include "GraphRegistry.hpp"
+#include <mutex>
+
+const char* const GraphRegistry::DEFAULT_GRAPH = "default";
+
+NamedGraph::NamedGraph(const std::string& name, GraphRegistry& registry)
+    : name(name), store(0),
+      caches([this, &registry](size_t bytes) { return registry.keepCached(*this, bytes); },
+             [this, &registry](size_t bytes) { registry.releaseCached(*this, bytes); }),
+      results(std::make_shared<ResultCache>()),
+      charged(0), cached(0), dropped(false), jobs(0) {}
+
+GraphRegistry::GraphRegistry(size_t graphQuota, size_t totalQuota, size_t maxGraphs)
+    : graphQuota(graphQuota), totalQuota(totalQuota), maxGraphs(maxGraphs), usedBytes(0) {
+    graphs[DEFAULT_GRAPH] = std::make_shared<NamedGraph>(DEFAULT_GRAPH, *this);
+}
+
+bool GraphRegistry::validName(std::string_view name) {
+    if (name.empty() || name.size() > MAX_GRAPH_NAME || (name[0] >= '0' && name[0] <= '9') || name[0] == '-'
+        || name[0] == '+') {
+        return false;
+    }
+    for (char c : name) {
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (!letter && !(c >= '0' && c <= '9') && c != '_' && c != '.' && c != '-') {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<NamedGraph> GraphRegistry::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    auto it = graphs.find(std::string(name));
+    return it != graphs.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<NamedGraph> GraphRegistry::open(std::string_view name) {
+    std::shared_ptr<NamedGraph> graph = find(name);
+    if (graph || !validName(name)) {
+        return graph;
+    }
+    std::unique_lock<std::shared_mutex> lock(mapMutex);
+    std::shared_ptr<NamedGraph>& slot = graphs[std::string(name)];
+    if (!slot) {
+        if (graphs.size() > maxGraphs) {
+            graphs.erase(std::string(name));
+            return nullptr;
+        }
+        slot = std::make_shared<NamedGraph>(std::string(name), *this);
+    }
+    return slot;
+}
+
+bool GraphRegistry::drop(std::string_view name) {
+    if (name == DEFAULT_GRAPH) {
+        return false;
+    }
+    std::shared_ptr<NamedGraph> graph;
+    {
+        std::unique_lock<std::shared_mutex> lock(mapMutex);
+        auto it = graphs.find(std::string(name));
+        if (it == graphs.end()) {
+            return false;
+        }
+        graph = it->second;
+        graphs.erase(it);
+    }
+    // under the writer lock of the graph, so no update of it is charged after the release
+    graph->store.update([this, &graph](Graph& contents) {
+        graph->dropped = true;
+        release(graph->charged);
+        graph->charged = 0;
+        contents.resetGraph(0);
+    });
+    graph->caches.clear();
+    return true;
+}
+
+GraphSnapshot GraphRegistry::snapshot(std::string_view name) const {
+    std::shared_ptr<NamedGraph> graph = find(name);
+    return graph ? graph->store.snapshot() : nullptr;
+}
+
+bool GraphRegistry::update(NamedGraph& graph, const std::function<size_t(const Graph&)>& projected,
+                           const std::function<void(Graph&)>& change) {
+    bool fits = false;
+    graph.store.update([&](Graph& contents) {
+        if (graph.dropped) {
+            return;
+        }
+        size_t after = projected(contents);
+        // shrinking is always allowed, even for a graph that ended up above its quota
+        if ((after > graph.charged && after > graphQuota) || !reserve(graph.charged, after)) {
+            return;
+        }
+        change(contents);
+        // the projection was an estimate, the graph is charged at its real size
+        size_t actual = contents.memoryUsage();
+        usedBytes += actual;
+        usedBytes -= after;
+        graph.charged = actual;
+        fits = true;
+    });
+    return fits;
+}
+
+bool GraphRegistry::keepCached(NamedGraph& graph, size_t bytes) {
+    if (graph.dropped) {
+        return false;
+    }
+    // the data of the graph comes first: its caches only get what it leaves of the graph quota
+    size_t current = graph.cached;
+    do {
+        if (graph.charged + current + bytes > graphQuota) {
+            return false;
+        }
+    } while (!graph.cached.compare_exchange_weak(current, current + bytes));
+    if (!reserve(0, bytes)) {
+        graph.cached -= bytes;
+        return false;
+    }
+    return true;
+}
+
+void GraphRegistry::releaseCached(NamedGraph& graph, size_t bytes) {
+    graph.cached -= bytes;
+    release(bytes);
+}
+
+size_t GraphRegistry::used() const {
+    return usedBytes;
+}
+
+size_t GraphRegistry::size() const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    return graphs.size();
+}
+
+// Charge newBytes instead of oldBytes, false if that would take all graphs above the total quota.
+// Shrinking always succeeds
+bool GraphRegistry::reserve(size_t oldBytes, size_t newBytes) {
+    size_t current = usedBytes;
+    do {
+        if (newBytes > oldBytes && current - oldBytes + newBytes > totalQuota) {
+            return false;
+        }
+    } while (!usedBytes.compare_exchange_weak(current, current - oldBytes + newBytes));
+    return true;
+}
+
+void GraphRegistry::release(size_t bytes) {
+    usedBytes -= bytes;
+}
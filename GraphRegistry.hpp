@@ -0,0 +1,101 @@
+#ifndef GRAPH_REGISTRY_HPP
+#define GRAPH_REGISTRY_HPP
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <shared_mutex>
+#include "GraphStore.hpp"
+#include "GraphCaches.hpp"
+#include "ResultCache.hpp"
+
+const size_t DEFAULT_GRAPH_QUOTA = size_t(512) << 20;      // bytes of one graph (Graph::memoryUsage)
+const size_t DEFAULT_TOTAL_QUOTA = size_t(2) << 30;        // bytes of all graphs together
+const size_t DEFAULT_MAX_GRAPHS = 64;
+const size_t MAX_GRAPH_NAME = 64;
+// Unfinished background jobs of one graph. Each pins the snapshot it was submitted on, a full copy
+// of the graph once the graph changed after it, so they are bounded per graph rather than only by
+// the job store
+const size_t MAX_GRAPH_JOBS = 8;
+
+class GraphRegistry;
+
+// One graph of the registry. charged is only changed by writers of its store, under the store's
+// writer lock, so every graph is charged in the order of its own updates. The query structures
+// its readers keep in caches are charged on top, as they are built
+struct NamedGraph {
+    NamedGraph(const std::string& name, GraphRegistry& registry);
+
+    const std::string name;
+    GraphStore store;
+    GraphCaches caches;
+    std::shared_ptr<ResultCache> results;   // MST results, shared with the jobs solving its snapshots
+    std::atomic<size_t> charged;    // bytes of the graph counted against the quotas
+    std::atomic<size_t> cached;     // bytes of the structures in caches
+    std::atomic<bool> dropped;      // removed from the registry, sessions look the name up again
+    std::atomic<size_t> jobs;       // unfinished background jobs on snapshots of it
+};
+
+// The graphs of all clients by name, so tenants do not overwrite each other. Every graph is a
+// GraphStore of its own: readers of one never wait for another, writers only wait for writers of
+// the same graph. The map itself is behind a shared_mutex, taken exclusively only to create and
+// drop graphs.
+//
+// Memory quotas are checked before a change runs, from the size the graph will have afterwards:
+// one graph may not grow above graphQuota, all of them together not above totalQuota. Sizes are
+// estimates of one version of a graph (Graph::memoryUsage); a published snapshot can keep an older
+// version alive for as long as its readers need it. The cached query structures of a graph count
+// too, but only fill what its data leaves of the quotas: a structure that does not fit is used by
+// the query that built it and not kept.
+class GraphRegistry {
+public:
+    // The graph of a session that did not pick one, always there
+    static const char* const DEFAULT_GRAPH;
+
+    GraphRegistry(size_t graphQuota = DEFAULT_GRAPH_QUOTA, size_t totalQuota = DEFAULT_TOTAL_QUOTA,
+                  size_t maxGraphs = DEFAULT_MAX_GRAPHS);
+
+    // Letters, digits, '_', '.' and '-', at most MAX_GRAPH_NAME, not starting like a number
+    static bool validName(std::string_view name);
+
+    // The graph with the given name, nullptr if there is none
+    std::shared_ptr<NamedGraph> find(std::string_view name) const;
+    // The graph with the given name, created empty if there is none. nullptr if the name is not
+    // valid or there are maxGraphs graphs already
+    std::shared_ptr<NamedGraph> open(std::string_view name);
+    // Remove the graph and give its memory back to the quota. The default graph cannot be dropped
+    bool drop(std::string_view name);
+
+    // Snapshot of the named graph, nullptr if there is none
+    GraphSnapshot snapshot(std::string_view name) const;
+
+    // Run change on the graph as its only writer if the graph, at the size projected returns for it,
+    // still fits the quotas. False if it does not (or the graph was dropped): nothing changed then
+    bool update(NamedGraph& graph, const std::function<size_t(const Graph&)>& projected,
+                const std::function<void(Graph&)>& change);
+
+    // Called by the caches of graph: charge a query structure of that many bytes, false if it does
+    // not fit the quotas (or the graph was dropped). release gives them back
+    bool keepCached(NamedGraph& graph, size_t bytes);
+    void releaseCached(NamedGraph& graph, size_t bytes);
+
+    // Bytes charged for all graphs and their caches
+    size_t used() const;
+    size_t size() const;
+
+private:
+    bool reserve(size_t oldBytes, size_t newBytes);
+    void release(size_t bytes);
+
+    const size_t graphQuota;
+    const size_t totalQuota;
+    const size_t maxGraphs;
+    mutable std::shared_mutex mapMutex;
+    std::unordered_map<std::string, std::shared_ptr<NamedGraph>> graphs;
+    std::atomic<size_t> usedBytes;
+};
+
+#endif // GRAPH_REGISTRY_HPP
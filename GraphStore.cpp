@@ -0,0 +1,23 @@
+#include "GraphStore.hpp"
+
+GraphStore::GraphStore(int numVertices)
+    : graph(numVertices), published(std::make_shared<const Graph>(graph)), stale(false) {}
+
+GraphSnapshot GraphStore::snapshot() const {
+    if (!stale.load(std::memory_order_acquire)) {
+        return std::atomic_load(&published);
+    }
+    std::lock_guard<std::mutex> lock(writerMutex);
+    // a write that changed nothing (an edge out of range) kept the generation, the snapshot still fits
+    if (stale.load(std::memory_order_relaxed) && published->getGeneration() != graph.getGeneration()) {
+        std::atomic_store(&published, GraphSnapshot(std::make_shared<const Graph>(graph)));
+    }
+    stale.store(false, std::memory_order_release);
+    return std::atomic_load(&published);
+}
+
+void GraphStore::update(const std::function<void(Graph&)>& change) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    change(graph);
+    stale.store(true, std::memory_order_release);
+}
@@ -0,0 +1,38 @@
+#ifndef GRAPH_STORE_HPP
+#define GRAPH_STORE_HPP
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "Graph.hpp"
+
+// An immutable version of the shared graph. Whoever holds one may read it from any thread for as
+// long as they like, without a lock: writers never touch a published version
+typedef std::shared_ptr<const Graph> GraphSnapshot;
+
+// The graph all clients share, read-copy-update style. Readers take the current snapshot with an
+// atomic load and solve on it without locking, so queries run in parallel and a writer never waits
+// for them. Writers run one at a time on a private copy and the result becomes the next snapshot.
+//
+// Publishing is lazy: a write only marks the copy newer than the snapshot, the first reader after
+// it publishes a new snapshot (one copy of the graph, under the writer lock). A stream of Newedge
+// commands thus costs one copy per query that follows it, not one copy per edge.
+class GraphStore {
+public:
+    explicit GraphStore(int numVertices);
+
+    // The current version, including every update that returned before the call
+    GraphSnapshot snapshot() const;
+
+    // Run change on the graph as its only writer. Readers that already hold a snapshot keep theirs
+    void update(const std::function<void(Graph&)>& change);
+
+private:
+    mutable std::mutex writerMutex;
+    Graph graph;                            // the writers' copy, only used under writerMutex
+    mutable GraphSnapshot published;        // read and replaced with std::atomic_load / atomic_store
+    mutable std::atomic<bool> stale;        // graph has changes the published snapshot lacks
+};
+
+#endif // GRAPH_STORE_HPP
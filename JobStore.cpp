@@ -0,0 +1,103 @@
+#include "JobStore.hpp"
+#include <iostream>
+#include <exception>
+#include <iterator>
+
+JobStore::JobStore(size_t numWorkers, size_t maxJobs)
+    : maxJobs(maxJobs), nextId(1), closing(false), pool(numWorkers) {}
+
+JobStore::~JobStore() {
+    closing = true;
+}
+
+uint64_t JobStore::submit(std::function<std::string()> task) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (jobs.size() >= maxJobs) {
+            // the least recently used finished job makes room
+            auto victim = recent.end();
+            for (auto it = recent.rbegin(); it != recent.rend(); ++it) {
+                State state = jobs[*it].state;
+                if (state == DONE || state == FAILED) {
+                    victim = std::prev(it.base());
+                    break;
+                }
+            }
+            if (victim == recent.end()) {
+                return 0;
+            }
+            jobs.erase(*victim);
+            recent.erase(victim);
+        }
+        id = nextId++;
+        recent.push_front(id);
+        jobs[id] = Job{QUEUED, "", recent.begin()};
+    }
+    pool.enqueue([this, id, task] { run(id, task); });
+    return id;
+}
+
+bool JobStore::find(uint64_t id, State& state, std::string& result) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = jobs.find(id);
+    if (it == jobs.end()) {
+        return false;
+    }
+    touch(it->second);
+    state = it->second.state;
+    if (state == DONE) {
+        result = it->second.result;
+    }
+    return true;
+}
+
+const char* JobStore::stateName(State state) {
+    switch (state) {
+        case QUEUED:
+            return "queued";
+        case RUNNING:
+            return "running";
+        case DONE:
+            return "done";
+        case FAILED:
+            return "failed";
+    }
+    return "unknown";
+}
+
+void JobStore::run(uint64_t id, const std::function<std::string()>& task) {
+    if (closing) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        jobs[id].state = RUNNING;
+    }
+    State state = DONE;
+    std::string result;
+    try {
+        result = task();
+    } catch (const std::exception& e) {
+        std::cerr << "Job " << id << " failed: " << e.what() << "\n";
+        state = FAILED;
+    } catch (...) {
+        // anything else would end the pool's worker, and the process with it
+        std::cerr << "Job " << id << " failed\n";
+        state = FAILED;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    Job& job = jobs[id];
+    job.state = state;
+    job.result = std::move(result);
+}
+
+// Move the job to the front of the eviction order, mtx must be held
+void JobStore::touch(Job& job) {
+    recent.splice(recent.begin(), recent, job.recent);
+}
+
+JobStore& sharedJobStore() {
+    static JobStore store;
+    return store;
+}
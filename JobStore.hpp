@@ -0,0 +1,61 @@
+#ifndef JOB_STORE_HPP
+#define JOB_STORE_HPP
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "ThreadPool.hpp"
+
+const size_t DEFAULT_JOB_WORKERS = 2;
+const size_t DEFAULT_MAX_JOBS = 1024;
+
+// Solves that run in the background: "Submit" answers with a job id right away, "Status" and
+// "Result" poll it, so one connection can have many solves running. Jobs run on a pool of their
+// own, never on the servers' client workers or on computePool (whose tasks must not wait on it).
+//
+// At most maxJobs are kept. A new job evicts the least recently polled finished one; when none has
+// finished, the job is refused instead, so a client that never collects cannot grow the store.
+class JobStore {
+public:
+    enum State { QUEUED, RUNNING, DONE, FAILED };
+
+    JobStore(size_t numWorkers = DEFAULT_JOB_WORKERS, size_t maxJobs = DEFAULT_MAX_JOBS);
+    // Jobs still queued are dropped, the running ones are finished
+    ~JobStore();
+
+    // Queue the task, its return value is the job's result. The id of the job, 0 if the store is
+    // full of unfinished jobs
+    uint64_t submit(std::function<std::string()> task);
+
+    // False if there is no such job (never submitted or evicted). result is only set once DONE
+    bool find(uint64_t id, State& state, std::string& result);
+
+    static const char* stateName(State state);
+
+private:
+    struct Job {
+        State state;
+        std::string result;
+        std::list<uint64_t>::iterator recent;
+    };
+
+    void run(uint64_t id, const std::function<std::string()>& task);
+    void touch(Job& job);
+
+    const size_t maxJobs;
+    std::mutex mtx;
+    std::unordered_map<uint64_t, Job> jobs;
+    std::list<uint64_t> recent;         // most recently submitted or polled first
+    uint64_t nextId;
+    std::atomic<bool> closing;
+    ThreadPool pool;                    // last: joined before anything its jobs use goes away
+};
+
+// Jobs of all clients of the server
+JobStore& sharedJobStore();
+
+#endif // JOB_STORE_HPP
@@ -0,0 +1,111 @@
+#include "LCAIndex.hpp"
+#include <utility>
+
+LCAIndex::LCAIndex(const std::vector<int>& parent) {
+    int n = static_cast<int>(parent.size());
+    first.assign(n, -1);
+    depth.assign(n, 0);
+    root.assign(n, -1);
+
+    // Children in CSR form
+    std::vector<int> childStart(n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        if (parent[v] != -1) {
+            childStart[parent[v] + 1]++;
+        }
+    }
+    for (int v = 0; v < n; ++v) {
+        childStart[v + 1] += childStart[v];
+    }
+    std::vector<int> children(childStart[n]);
+    std::vector<int> fillPos(childStart.begin(), childStart.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        if (parent[v] != -1) {
+            children[fillPos[parent[v]]++] = v;
+        }
+    }
+
+    // Iterative Euler tour (trees can be deep, no recursion), a node is written when it is
+    // entered and again after each of its children
+    euler.reserve(n > 0 ? 2 * n - 1 : 0);
+    std::vector<std::pair<int, int>> stack;     // (node, next child position)
+    for (int r = 0; r < n; ++r) {
+        if (parent[r] != -1) {
+            continue;
+        }
+        root[r] = r;
+        first[r] = static_cast<int>(euler.size());
+        euler.push_back(r);
+        stack.push_back({r, childStart[r]});
+        while (!stack.empty()) {
+            int node = stack.back().first;
+            int& next = stack.back().second;
+            if (next == childStart[node + 1]) {
+                stack.pop_back();
+                if (!stack.empty()) {
+                    euler.push_back(stack.back().first);
+                }
+                continue;
+            }
+            int child = children[next++];
+            depth[child] = depth[node] + 1;
+            root[child] = r;
+            first[child] = static_cast<int>(euler.size());
+            euler.push_back(child);
+            stack.push_back({child, childStart[child]});
+        }
+    }
+
+    // Sparse table over the tour
+    int m = static_cast<int>(euler.size());
+    sparse.push_back(euler);
+    for (int k = 1; (1 << k) <= m; ++k) {
+        const std::vector<int>& prev = sparse[k - 1];
+        std::vector<int> level(m - (1 << k) + 1);
+        for (int i = 0; i + (1 << k) <= m; ++i) {
+            int a = prev[i];
+            int b = prev[i + (1 << (k - 1))];
+            level[i] = depth[a] <= depth[b] ? a : b;
+        }
+        sparse.push_back(std::move(level));
+    }
+}
+
+int LCAIndex::lca(int u, int v) const {
+    if (root[u] != root[v]) {
+        return -1;
+    }
+    int left = first[u];
+    int right = first[v];
+    if (left > right) {
+        std::swap(left, right);
+    }
+    int k = 31 - __builtin_clz(right - left + 1);
+    int a = sparse[k][left];
+    int b = sparse[k][right - (1 << k) + 1];
+    return depth[a] <= depth[b] ? a : b;
+}
+
+int LCAIndex::getDepth(int u) const {
+    return depth[u];
+}
+
+int LCAIndex::getRoot(int u) const {
+    return root[u];
+}
+
+int LCAIndex::size() const {
+    return static_cast<int>(depth.size());
+}
+
+size_t LCAIndex::memoryUsage() const {
+    size_t bytes = sizeof(LCAIndex) + (euler.capacity() + first.capacity() + depth.capacity() + root.capacity()) * sizeof(int);
+    for (const std::vector<int>& level : sparse) {
+        bytes += sizeof(level) + level.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+const std::vector<int>& LCAIndex::getEulerTour() const {
+    return euler;
+}
@@ -0,0 +1,35 @@
+#ifndef LCA_INDEX_HPP
+#define LCA_INDEX_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Lowest common ancestor in O(1) per query: Euler tour of a rooted forest and a sparse table
+// of range minimums over the tour depths. Build is O(N log N) time and memory.
+class LCAIndex {
+private:
+    std::vector<int> euler;                 // nodes in Euler tour order (all trees one after the other)
+    std::vector<int> first;                 // first position of every node in the tour
+    std::vector<int> depth;                 // depth of every node (root = 0)
+    std::vector<int> root;                  // root of the tree every node belongs to
+    std::vector<std::vector<int>> sparse;   // sparse[k][i] = shallowest node in euler[i, i + 2^k)
+
+public:
+    LCAIndex() {}
+    // parent[i] is the parent of node i, -1 for the roots
+    LCAIndex(const std::vector<int>& parent);
+
+    // Lowest common ancestor of u and v, -1 if they are in different trees
+    int lca(int u, int v) const;
+
+    int getDepth(int u) const;
+    int getRoot(int u) const;
+    int size() const;
+    // Estimated heap and object size, for memory quotas
+    size_t memoryUsage() const;
+
+    // Nodes in Euler tour order, useful for prefix computations over the tree
+    const std::vector<int>& getEulerTour() const;
+};
+
+#endif // LCA_INDEX_HPP
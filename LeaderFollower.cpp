@@ -0,0 +1,179 @@
+#include "LeaderFollower.hpp"
+#include <iostream>
+#include <chrono>
+#include <exception>
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#define READ_CHUNK 65536
+#define POLL_INTERVAL_MS 1000
+
+static long long nowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Send all of data on a non-blocking socket, waiting for room when it is full. False if the
+// client is gone or made no room for timeoutMs
+static bool sendAll(int socket, const std::string& data, int timeoutMs) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n >= 0) {
+            sent += n;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            pollfd writable{socket, POLLOUT, 0};
+            if (poll(&writable, 1, timeoutMs) == 0) {
+                std::cout << "Client not reading its replies, dropped.\n";
+                return false;
+            }
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+LeaderFollowerPool::Connection::Connection(int socket, GraphRegistry& graphs)
+    : socket(socket), session(graphs) {}
+
+LeaderFollowerPool::LeaderFollowerPool(int listenSocket, GraphRegistry& graphs, int sendTimeoutMs)
+    : listenSocket(listenSocket), graphs(graphs), sendTimeoutMs(sendTimeoutMs), numConnections(0), lastActivity(nowSeconds()),
+      stop(false) {
+    fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL, 0) | O_NONBLOCK);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = nullptr;       // the listening socket
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenSocket, &event);
+}
+
+LeaderFollowerPool::~LeaderFollowerPool() {
+    close(epollFd);
+    close(listenSocket);
+}
+
+void LeaderFollowerPool::run(size_t numThreads, int idleSeconds) {
+    std::vector<std::thread> followers;
+    for (size_t i = 1; i < numThreads; ++i) {
+        followers.emplace_back(&LeaderFollowerPool::threadLoop, this, idleSeconds);
+    }
+    threadLoop(idleSeconds);
+    for (std::thread& follower : followers) {
+        follower.join();
+    }
+}
+
+void LeaderFollowerPool::threadLoop(int idleSeconds) {
+    while (true) {
+        epoll_event event;
+        int ready;
+        {
+            // become the leader: wait for the one event, then promote the next follower
+            std::lock_guard<std::mutex> leader(leaderMutex);
+            if (stop) {
+                return;
+            }
+            ready = epoll_wait(epollFd, &event, 1, POLL_INTERVAL_MS);
+            if (ready == 0 && numConnections == 0 && nowSeconds() - lastActivity >= idleSeconds) {
+                std::cout << "No connections for " << idleSeconds << " seconds. Exiting...\n";
+                stop = true;
+                return;
+            }
+        }
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                perror("epoll_wait");
+            }
+            continue;
+        }
+
+        // process the event as a follower, the new leader already waits for the next one
+        if (event.data.ptr == nullptr) {
+            acceptAll();
+            rearm(listenSocket, nullptr);
+            continue;
+        }
+        Connection* connection = static_cast<Connection*>(event.data.ptr);
+        if (handle(*connection)) {
+            rearm(connection->socket, connection);
+        } else {
+            // closing removes the socket from the epoll set, and being one-shot no other
+            // thread holds an event for it
+            close(connection->socket);
+            delete connection;
+            numConnections--;
+            lastActivity = nowSeconds();
+            std::cout << "Client disconnected.\n";
+        }
+    }
+}
+
+void LeaderFollowerPool::acceptAll() {
+    while (true) {
+        int client = accept4(listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+            }
+            return;
+        }
+        Connection* connection = new Connection(client, graphs);
+        numConnections++;
+        lastActivity = nowSeconds();
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = connection;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &event);
+        std::cout << "Client connected, socket " << client << std::endl;
+    }
+}
+
+// Read what the client sent, run the complete commands and reply. False once the client is gone
+bool LeaderFollowerPool::handle(Connection& connection) {
+    char buffer[READ_CHUNK];
+    bool open = true;
+    while (true) {
+        ssize_t bytesReceived = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (bytesReceived > 0) {
+            connection.framer.feed(buffer, bytesReceived);
+        } else if (bytesReceived < 0 && errno == EINTR) {
+            continue;
+        } else {
+            open = bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+    }
+
+    // a partial command stays buffered for the next segment, unless the client hung up
+    std::string command;
+    while (connection.framer.nextCommand(command, !open)) {
+        std::string response;
+        try {
+            response = connection.framer.isBinary() ? connection.session.executeFrame(command) : connection.session.execute(command);
+        } catch (const std::exception& e) {
+            std::cerr << "Command failed: " << e.what() << "\n";
+        }
+        if (open && !response.empty() && !sendAll(connection.socket, response, sendTimeoutMs)) {
+            // dropped: nothing more of its buffer runs, a command cut short there must not
+            // count as complete
+            return false;
+        }
+    }
+    return open;
+}
+
+void LeaderFollowerPool::rearm(int socket, void* data) {
+    epoll_event event{};
+    event.events = data ? EPOLLIN | EPOLLRDHUP | EPOLLONESHOT : EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = data;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, socket, &event);
+}
@@ -0,0 +1,55 @@
+#ifndef LEADER_FOLLOWER_HPP
+#define LEADER_FOLLOWER_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "GraphRegistry.hpp"
+#include "ServerSession.hpp"
+
+// A client that leaves no room for its replies for this long is dropped, so it cannot hold one of
+// the threads forever
+const int DEFAULT_SEND_TIMEOUT_MS = 5000;
+
+// Leader-Follower server threads over one epoll set. One thread, the leader, waits for an event;
+// when it gets one it promotes the next follower to leader and then handles the event itself, so
+// the event never passes through a queue or to another thread.
+//
+// The followers wait on leaderMutex: whoever holds it is the leader, unlocking it is the
+// promotion. Every socket is registered with EPOLLONESHOT, so an event goes to exactly one thread
+// and the socket is only re-armed once that thread is done with it.
+class LeaderFollowerPool {
+public:
+    // listenSocket must be bound and listening, it is made non-blocking and owned by the pool
+    LeaderFollowerPool(int listenSocket, GraphRegistry& graphs, int sendTimeoutMs = DEFAULT_SEND_TIMEOUT_MS);
+    ~LeaderFollowerPool();
+
+    // Serve with numThreads threads (the caller is one of them) until there were no connections
+    // for idleSeconds
+    void run(size_t numThreads, int idleSeconds);
+
+private:
+    struct Connection {
+        Connection(int socket, GraphRegistry& graphs);
+        int socket;
+        CommandFramer framer;
+        ClientSession session;
+    };
+
+    void threadLoop(int idleSeconds);
+    void acceptAll();
+    bool handle(Connection& connection);
+    void rearm(int socket, void* data);
+
+    int listenSocket;
+    int epollFd;
+    GraphRegistry& graphs;
+    const int sendTimeoutMs;
+    std::mutex leaderMutex;
+    std::atomic<int> numConnections;
+    std::atomic<long long> lastActivity;    // steady clock, in seconds
+    std::atomic<bool> stop;
+};
+
+#endif // LEADER_FOLLOWER_HPP
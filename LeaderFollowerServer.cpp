@@ -0,0 +1,64 @@
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <cerrno>
+#include "GraphRegistry.hpp"
+#include "LeaderFollower.hpp"
+
+using namespace std;        // TODO make it more specific later
+
+// ---------------------------- Constants and Global vars ----------------------------
+#define PORT 9034
+#define MAXCONNECTIONS SOMAXCONN
+#define IDLE_EXIT_SEC 15
+#define NUM_THREADS 10      // same as threadpoll_server, for comparing the two
+GraphRegistry graphs;
+
+// ---------------------------- Main ----------------------------
+int main() {
+    // Create a socket
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server == -1) {
+        std::cerr << "socket: Could not create socket.\n";
+        return 1;
+    }
+
+    // Set server address for binding
+    sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(PORT);
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+
+    // Allow reuse of address
+    int yes = 1;
+    if (setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1) {
+        std::cerr << "setsockopt: Could not set socket options.\n";
+        return 2;
+    }
+
+    // Bind to port
+    if (bind(server, (sockaddr *) &serverAddr, sizeof(serverAddr)) == -1) {
+        std::cerr << "bind: Could not bind to port " << PORT << ".\n";
+        return 3;
+    }
+
+    // Listen on port for incoming connections
+    if (listen(server, MAXCONNECTIONS) == -1) {
+        std::cerr << "listen: Could not listen on port " << PORT << ".\n";
+        // print error
+        std::cout << "Error: " << strerror(errno) << "\n";
+        return 4;
+    }
+
+    // The threads take turns waiting for events, each one handles the event it got itself
+    std::cout << "Waiting for connections..." << std::endl;
+    LeaderFollowerPool pool(server, graphs);
+    pool.run(NUM_THREADS, IDLE_EXIT_SEC);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "MSTClustering.hpp"
+#include "MSTSolver.hpp"
+#include <algorithm>
+
+Dendrogram::Dendrogram(int num_vertices, const std::vector<Edge>& mst) : num_vertices(num_vertices) {
+    // Sort the MST edges once, single linkage merges the closest clusters first
+    std::vector<Edge> sorted(mst);
+    std::sort(sorted.begin(), sorted.end(), [](const Edge& a, const Edge& b) {
+        return a.weight < b.weight;
+    });
+
+    std::vector<int> dsuParent(num_vertices);
+    std::vector<int> dsuRank(num_vertices, 0);
+    std::vector<int> clusterOf(num_vertices);   // dendrogram node currently represented by a DSU root
+    std::vector<int> sizeOf(num_vertices, 1);
+    for (int i = 0; i < num_vertices; ++i) {
+        dsuParent[i] = i;
+        clusterOf[i] = i;
+    }
+    parent.assign(num_vertices, -1);
+
+    for (const Edge& edge : sorted) {
+        if (edge.u < 0 || edge.u >= num_vertices || edge.v < 0 || edge.v >= num_vertices) {
+            continue;
+        }
+        int rootU = find(dsuParent, edge.u);
+        int rootV = find(dsuParent, edge.v);
+        if (rootU == rootV) {
+            continue;
+        }
+
+        int node = num_vertices + static_cast<int>(merges.size());
+        int size = sizeOf[rootU] + sizeOf[rootV];
+        merges.push_back({clusterOf[rootU], clusterOf[rootV], edge.weight, size});
+        parent[clusterOf[rootU]] = node;
+        parent[clusterOf[rootV]] = node;
+        parent.push_back(-1);
+
+        unionSets(dsuParent, dsuRank, rootU, rootV);
+        int root = find(dsuParent, rootU);
+        clusterOf[root] = node;
+        sizeOf[root] = size;
+    }
+}
+
+std::vector<int> Dendrogram::labelsAfter(size_t numMerges) const {
+    numMerges = std::min(numMerges, merges.size());
+    int limit = num_vertices + static_cast<int>(numMerges);
+
+    // A parent always has a larger id than its children, so walking the ids downwards
+    // resolves the topmost cluster (with id < limit) of every node in one pass
+    std::vector<int> top(limit);
+    for (int node = limit - 1; node >= 0; --node) {
+        int p = parent[node];
+        top[node] = (p != -1 && p < limit) ? top[p] : node;
+    }
+
+    // Compact the cluster ids to 0..k-1, numbered by their smallest vertex
+    std::vector<int> remap(limit, -1);
+    std::vector<int> labels(num_vertices);
+    int next = 0;
+    for (int v = 0; v < num_vertices; ++v) {
+        int& label = remap[top[v]];
+        if (label == -1) {
+            label = next++;
+        }
+        labels[v] = label;
+    }
+    return labels;
+}
+
+std::vector<int> Dendrogram::clustersK(int k) const {
+    if (k < 1) {
+        k = 1;
+    }
+    size_t numMerges = k >= num_vertices ? 0 : static_cast<size_t>(num_vertices - k);
+    return labelsAfter(numMerges);
+}
+
+std::vector<int> Dendrogram::clustersAtThreshold(int threshold) const {
+    // merges are sorted by weight, so the merges to apply are a prefix
+    auto it = std::upper_bound(merges.begin(), merges.end(), threshold, [](int t, const DendrogramMerge& merge) {
+        return t < merge.weight;
+    });
+    return labelsAfter(static_cast<size_t>(it - merges.begin()));
+}
+
+const std::vector<DendrogramMerge>& Dendrogram::getMerges() const {
+    return merges;
+}
+
+const std::vector<int>& Dendrogram::getParents() const {
+    return parent;
+}
+
+int Dendrogram::getNumVertices() const {
+    return num_vertices;
+}
+
+size_t Dendrogram::memoryUsage() const {
+    return sizeof(Dendrogram) + merges.capacity() * sizeof(DendrogramMerge) + parent.capacity() * sizeof(int);
+}
+
+std::string Dendrogram::printClusters(const std::vector<int>& labels) {
+    int numClusters = 0;
+    for (int label : labels) {
+        numClusters = std::max(numClusters, label + 1);
+    }
+    std::vector<std::vector<int>> members(numClusters);
+    for (int v = 0; v < static_cast<int>(labels.size()); ++v) {
+        members[labels[v]].push_back(v);
+    }
+
+    std::string response = "Clusters: " + std::to_string(numClusters) + "\n";
+    for (int c = 0; c < numClusters; ++c) {
+        response += "Cluster " + std::to_string(c) + ":";
+        for (int v : members[c]) {
+            response += " " + std::to_string(v);
+        }
+        response += "\n";
+    }
+    return response;
+}
@@ -0,0 +1,50 @@
+#ifndef MST_CLUSTERING_HPP
+#define MST_CLUSTERING_HPP
+
+#include <vector>
+#include <string>
+#include "Graph.hpp"
+
+// One merge step of the single-linkage dendrogram.
+// Cluster ids: 0..V-1 are the single vertices (leaves), merge i creates cluster V+i.
+struct DendrogramMerge {
+    int left, right;    // ids of the two merged clusters
+    int weight;         // MST edge weight at which they merge
+    int size;           // number of vertices in the merged cluster
+};
+
+// Single-linkage clustering built from an MST.
+// The MST edges are sorted once and merged with a DSU (O(V log V)), after that every
+// "k clusters" / "cut at threshold" query is answered in O(V) from the cached dendrogram.
+class Dendrogram {
+private:
+    int num_vertices;
+    std::vector<DendrogramMerge> merges;    // sorted by weight (merge order)
+    std::vector<int> parent;                // parent cluster of every dendrogram node, -1 for roots
+
+public:
+    // Build the dendrogram of a graph with num_vertices vertices from its MST edges
+    Dendrogram(int num_vertices, const std::vector<Edge>& mst);
+
+    // Cluster label (0..k-1) of every vertex when the tree is cut into k clusters.
+    // k is clamped to [number of connected components, V]
+    std::vector<int> clustersK(int k) const;
+
+    // Cluster label of every vertex when all MST edges heavier than threshold are removed
+    std::vector<int> clustersAtThreshold(int threshold) const;
+
+    const std::vector<DendrogramMerge>& getMerges() const;
+    const std::vector<int>& getParents() const;
+    int getNumVertices() const;
+    // Estimated heap and object size, for memory quotas
+    size_t memoryUsage() const;
+
+    // Text rendering of a labeling, one line per cluster
+    static std::string printClusters(const std::vector<int>& labels);
+
+private:
+    // Labels after applying the first numMerges merges, in O(V)
+    std::vector<int> labelsAfter(size_t numMerges) const;
+};
+
+#endif // MST_CLUSTERING_HPP
@@ -6,6 +6,8 @@ std::unique_ptr<MSTSolver> MSTFactory::createSolver(MSTType type) {
             return std::unique_ptr<MSTSolver>(new BoruvkaSolver());
         case PRIM:
             return std::unique_ptr<MSTSolver>(new PrimSolver());
+        case PARALLEL_KRUSKAL:
+            return std::unique_ptr<MSTSolver>(new ParallelKruskalSolver());
         default:
             std::cout << "Invalid MST type" << std::endl;
             return nullptr;
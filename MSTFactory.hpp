@@ -7,7 +7,7 @@
 
 class MSTFactory {
 public:
-    enum MSTType { BORUVKA, PRIM };
+    enum MSTType { BORUVKA, PRIM, PARALLEL_KRUSKAL };
     // using unique_ptr to avoid memory leaks (and some more advantages)
     static std::unique_ptr<MSTSolver> createSolver(MSTType type);
 };
@@ -1,4 +1,6 @@
 #include "MSTSolver.hpp"
+#include "BoruvkaKernels.hpp"
+#include "TreeMetrics.hpp"
 #include <algorithm>
 #include <climits>
 #include <set>
@@ -7,45 +9,43 @@
 
 
 // ---------------------------- Calculate Metrics ----------------------------
-int MSTSolver::totalWeight(Graph& graph) {
+long long MSTSolver::totalWeight(const Graph& graph) {
     std::vector<Edge> mst = solve(graph);
     return totalWeight(mst);
 }
 
-int MSTSolver::longestDistance(Graph& graph) {
+long long MSTSolver::longestDistance(const Graph& graph) {
     std::vector<Edge> mst = solve(graph);
     return longestDistance(mst);
 }
 
-int MSTSolver::shortestDistance(Graph& graph) {
+int MSTSolver::shortestDistance(const Graph& graph) {
     std::vector<Edge> mst = solve(graph);
     return shortestDistance(mst);
 }
 
-double MSTSolver::averageDistance(Graph& graph) {
+double MSTSolver::averageDistance(const Graph& graph) {
     std::vector<Edge> mst = solve(graph);
-    return totalWeight(mst);
+    return averageDistance(mst);
 }
 
-int MSTSolver::totalWeight(std::vector<Edge>& mst){
-    int totalWeight = 0;
-    int numEdges = 0;
+long long MSTSolver::totalWeight(std::vector<Edge>& mst){
+    long long totalWeight = 0;
     for (const Edge& edge : mst) {
         totalWeight += edge.weight;
-        numEdges++;
     }
-    return static_cast<double>(totalWeight) / numEdges;
+    return totalWeight;
 }
 
-int MSTSolver::longestDistance(std::vector<Edge>& mst){
-    int longestDistance = 0;
-    for (const Edge& edge : mst) {
-        longestDistance = std::max(longestDistance, edge.weight);
-    }
-    return longestDistance;
+long long MSTSolver::longestDistance(std::vector<Edge>& mst){
+    return treeDiameter(TreeAdjacency(mst));
 }
 
 int MSTSolver::shortestDistance(std::vector<Edge>& mst){
+    if (mst.empty()) {
+        return 0;
+    }
+    // the closest pair of different vertices is always joined by a single edge
     int shortestDistance = INT_MAX;
     for (const Edge& edge : mst) {
         shortestDistance = std::min(shortestDistance, edge.weight);
@@ -54,27 +54,30 @@ int MSTSolver::shortestDistance(std::vector<Edge>& mst){
 }
 
 double MSTSolver::averageDistance(std::vector<Edge>& mst){
-    int totalWeight = 0;
-    int numEdges = 0;
-    for (const Edge& edge : mst) {
-        totalWeight += edge.weight;
-        numEdges++;
+    if (mst.empty()) {
+        return 0;
     }
-    return static_cast<double>(totalWeight) / numEdges;
+    // pairs (i, j) with j >= i, the n pairs (x, x) count with distance 0
+    long long n = static_cast<long long>(mst.size()) + 1;
+    long long numPairs = n * (n + 1) / 2;
+    return static_cast<double>(pairwiseDistanceSum(TreeAdjacency(mst))) / numPairs;
+}
+
+MetricsResult MSTSolver::metrics(std::vector<Edge>& mst) {
+    return computeMetrics(mst);
 }
 
-std::string MSTSolver::printMetrics(Graph& graph){
+MetricsResult MSTSolver::metrics(const Graph& graph) {
     std::vector<Edge> mst = solve(graph);
-    return printMetrics(mst);
+    return computeMetrics(mst);
+}
+
+std::string MSTSolver::printMetrics(const Graph& graph){
+    return ::printMetrics(metrics(graph));
 }
 
 std::string MSTSolver::printMetrics(std::vector<Edge>& mst){
-    std::string response = "Metrics:\n";
-    response += "Total weight: " + std::to_string(totalWeight(mst)) + "\n";
-    response += "Longest distance: " + std::to_string(longestDistance(mst)) + "\n";
-    response += "Shortest distance: " + std::to_string(shortestDistance(mst)) + "\n";
-    response += "Average distance: " + std::to_string(averageDistance(mst)) + "\n";
-    return response;
+    return ::printMetrics(metrics(mst));
 }
 
 
@@ -102,7 +105,7 @@ void unionSets(std::vector<int>& parent, std::vector<int>& rank, int u, int v) {
 }
 
 // Boruvka's algorithm implementation
-std::vector<Edge> BoruvkaSolver::solve(Graph& graph) {
+std::vector<Edge> BoruvkaSolver::solve(const Graph& graph) {
     if (!graph.isConnected()) {
         return {};
     }
@@ -116,66 +119,65 @@ std::vector<Edge> BoruvkaSolver::solve(Graph& graph) {
         parent[i] = i;
     }
 
+    // Edge list as structure-of-arrays for the cheapest-edge kernel, each undirected edge once
+    std::vector<int> edgeU, edgeV, edgeWeight;
+    for (const Edge& edge : graph.getEdges()) {
+        if (edge.u < edge.v) {
+            edgeU.push_back(edge.u);
+            edgeV.push_back(edge.v);
+            edgeWeight.push_back(edge.weight);
+        }
+    }
+
+    // Component label of every vertex, recomputed once per round so the kernel needs no find()
+    std::vector<int> component(numVertices);
+    // Cheapest outgoing edge of every component, packed as (weight, edge index) keys
+    std::vector<uint64_t> cheapestEdge(numVertices);
+
     int numComponents = numVertices;
 
     // Continue until there is only one component
     while (numComponents > 1) {
-        // Array to store the cheapest outgoing edge for each component
-        std::vector<Edge> cheapestEdge(numVertices, Edge{-1, -1, std::numeric_limits<int>::max()});
-
-        // Traverse all edges and find the cheapest outgoing edge for each component
-        for (const Edge& edge : graph.getEdges()) {
-            int u = edge.u;
-            int v = edge.v;
-            int weight = edge.weight;
-
-            // Find the set (component) for both vertices
-            int setU = find(parent, u);
-            int setV = find(parent, v);
-
-            // We only care about outgoing edges, so ensure u -> v is the correct direction
-            if (setU != setV) {
-                // Update the cheapest outgoing edge for setU
-                if (cheapestEdge[setU].weight > weight) {
-                    cheapestEdge[setU] = edge;
-                }
-                // Update the cheapest outgoing edge for setV
-                if (cheapestEdge[setV].weight > weight) {
-                    cheapestEdge[setV] = edge;
-                }
-            }
+        for (int i = 0; i < numVertices; ++i) {
+            component[i] = find(parent, i);
         }
+        std::fill(cheapestEdge.begin(), cheapestEdge.end(), std::numeric_limits<uint64_t>::max());
+
+        // Find the cheapest outgoing edge for each component
+        cheapestEdges(edgeU.data(), edgeV.data(), edgeWeight.data(), edgeU.size(), component.data(), cheapestEdge.data());
 
         // Add the cheapest edges to the MST and perform union of sets
+        int mergedComponents = 0;
         for (int i = 0; i < numVertices; ++i) {
-            const Edge& edge = cheapestEdge[i];
-
             // If a valid cheapest edge was found for this component
-            if (edge.u != -1 && edge.v != -1) {
-                int setU = find(parent, edge.u);
-                int setV = find(parent, edge.v);
-
-                // If the components are different, include this edge in MST
-                if (setU != setV) {
-                    mstEdges.push_back(edge);
-                    unionSets(parent, rank, setU, setV);
-                    numComponents--;  // We've merged two components
-                }
+            if (cheapestEdge[i] == std::numeric_limits<uint64_t>::max()) {
+                continue;
             }
-        }
+            uint32_t index = edgeKeyIndex(cheapestEdge[i]);
+            int setU = find(parent, edgeU[index]);
+            int setV = find(parent, edgeV[index]);
 
-        // Reset the cheapest edges for the next iteration
-        std::fill(cheapestEdge.begin(), cheapestEdge.end(), Edge{-1, -1, std::numeric_limits<int>::max()});
+            // If the components are different, include this edge in MST
+            if (setU != setV) {
+                mstEdges.push_back(Edge(edgeU[index], edgeV[index], edgeWeight[index]));
+                unionSets(parent, rank, setU, setV);
+                mergedComponents++;  // We've merged two components
+            }
+        }
+        if (mergedComponents == 0) {
+            break;
+        }
+        numComponents -= mergedComponents;
     }
 
     return mstEdges;
 }
 
-std::vector<Edge> PrimSolver::solve(Graph& graph) {
-    if (!graph.isConnected()) {
+std::vector<Edge> PrimSolver::solve(const Graph& graph) {
+    int numVertices = graph.getNumVertices();
+    if (numVertices == 0 || !graph.isConnected()) {
         return {};
     }
-    int numVertices = graph.getNumVertices();
     
     std::vector<int> key(numVertices, INT_MAX);  // Key values to pick the minimum edge weight
     std::vector<bool> inMST(numVertices, false); // To keep track of vertices included in MST
@@ -3,45 +3,73 @@
 
 #include <vector>
 #include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "TreeMetrics.hpp"
+
+// Disjoint-set/union-find helpers (defined in MSTSolver.cpp), shared by the solvers and the clustering stage
+int find(std::vector<int>& parent, int i);
+void unionSets(std::vector<int>& parent, std::vector<int>& rank, int u, int v);
+
+// Sort edges by (weight, u, v) with a multi-threaded sample sort on the given pool.
+// Inputs smaller than minParallelSize are sorted with std::sort on the calling thread.
+void parallelSortEdges(std::vector<Edge>& edges, ThreadPool& pool, size_t minParallelSize = 1 << 16);
 
 class MSTSolver {
 public:
     virtual ~MSTSolver() {}
     // Solve the MST problem for the given graph
-    virtual std::vector<Edge> solve(Graph& graph) = 0;
+    virtual std::vector<Edge> solve(const Graph& graph) = 0;
     // Total weight of the MST
-    virtual int totalWeight(Graph& graph);
-    // Longest distance between two vertices
-    virtual int longestDistance(Graph& graph);
-    // Shortest distance between two vertices
-    virtual int shortestDistance(Graph& graph);
+    virtual long long totalWeight(const Graph& graph);
+    // Longest distance between two vertices in the MST (weighted tree diameter)
+    virtual long long longestDistance(const Graph& graph);
+    // Shortest distance between two different vertices in the MST (lightest edge, weights are non-negative)
+    virtual int shortestDistance(const Graph& graph);
     /*
-     * Average distance between two edges in the graph
+     * Average distance between two vertices in the MST
      * assume distance (x,x)=0 for any X, We are interested in avg of all distances Xi,Xj where i=1..n j≥i.
      */
-    virtual double averageDistance(Graph& graph);
+    virtual double averageDistance(const Graph& graph);
 
     // if we have the MST, we can calculate the metrics without solving the MST again
-    virtual int totalWeight(std::vector<Edge>& mst);
-    virtual int longestDistance(std::vector<Edge>& mst);
+    // (all of them O(V), see TreeMetrics.hpp)
+    virtual long long totalWeight(std::vector<Edge>& mst);
+    virtual long long longestDistance(std::vector<Edge>& mst);
     virtual int shortestDistance(std::vector<Edge>& mst);
     virtual double averageDistance(std::vector<Edge>& mst);
 
+    // All metrics in one fused pass (see TreeMetrics.hpp), the Graph overload solves once
+    MetricsResult metrics(std::vector<Edge>& mst);
+    MetricsResult metrics(const Graph& graph);
+
     std::string printMetrics(std::vector<Edge>& mst);
-    std::string printMetrics(Graph& graph);
+    std::string printMetrics(const Graph& graph);
 
 };
 
 class BoruvkaSolver : public MSTSolver {
 public:
-    std::vector<Edge> solve(Graph& graph) override;
+    std::vector<Edge> solve(const Graph& graph) override;
     // virtual int totalWeight(Graph& graph);
 };
 
 class PrimSolver : public MSTSolver {
 public:
-    std::vector<Edge> solve(Graph& graph) override;
+    std::vector<Edge> solve(const Graph& graph) override;
     // virtual int totalWeight(Graph& graph);
 };
 
+// Kruskal with a parallel sample sort and a filtered union pass, see ParallelKruskal.cpp
+class ParallelKruskalSolver : public MSTSolver {
+public:
+    ParallelKruskalSolver(ThreadPool& pool = computePool());
+    std::vector<Edge> solve(const Graph& graph) override;
+    // Minimum spanning forest, one tree per connected component: what solve returns for a
+    // connected graph, and still the trees of the components for a disconnected one
+    std::vector<Edge> spanningForest(const Graph& graph);
+
+private:
+    ThreadPool& pool;
+};
+
 #endif // MST_SOLVER_HPP
\ No newline at end of file
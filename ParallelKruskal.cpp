@@ -0,0 +1,168 @@
+#include "MSTSolver.hpp"
+#include <algorithm>
+#include <cstdint>
+
+// Total order on edges (weight first), so the sample sort splits evenly even with many equal weights
+static bool edgeLess(const Edge& a, const Edge& b) {
+    if (a.weight != b.weight) {
+        return a.weight < b.weight;
+    }
+    if (a.u != b.u) {
+        return a.u < b.u;
+    }
+    return a.v < b.v;
+}
+
+// ---------------------------- Parallel sample sort ----------------------------
+void parallelSortEdges(std::vector<Edge>& edges, ThreadPool& pool, size_t minParallelSize) {
+    size_t n = edges.size();
+    size_t numThreads = pool.size() + 1;    // parallelFor also runs a chunk on the calling thread
+    if (n < minParallelSize || n < 2 || numThreads < 2) {
+        std::sort(edges.begin(), edges.end(), edgeLess);
+        return;
+    }
+
+    // 1. Pick the bucket splitters from a regular oversample. A few buckets per thread keeps the
+    //    final per-bucket sorts balanced even when the splitters are not perfect
+    const size_t oversample = 32;
+    size_t numBuckets = numThreads * 4;
+    size_t sampleSize = std::min(n, numBuckets * oversample);
+    std::vector<Edge> sample;
+    sample.reserve(sampleSize);
+    for (size_t i = 0; i < sampleSize; ++i) {
+        sample.push_back(edges[i * n / sampleSize]);
+    }
+    std::sort(sample.begin(), sample.end(), edgeLess);
+    std::vector<Edge> splitters;
+    for (size_t b = 1; b < numBuckets; ++b) {
+        splitters.push_back(sample[b * sampleSize / numBuckets]);
+    }
+
+    // 2. Every chunk classifies its edges and counts them per bucket
+    size_t numChunks = numThreads;
+    std::vector<uint32_t> bucketOf(n);
+    std::vector<size_t> counts(numChunks * numBuckets, 0);
+    pool.parallelFor(numChunks, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t c = firstChunk; c < lastChunk; ++c) {
+            size_t* count = &counts[c * numBuckets];
+            for (size_t i = c * n / numChunks; i < (c + 1) * n / numChunks; ++i) {
+                size_t b = std::upper_bound(splitters.begin(), splitters.end(), edges[i], edgeLess) - splitters.begin();
+                bucketOf[i] = static_cast<uint32_t>(b);
+                count[b]++;
+            }
+        }
+    });
+
+    // 3. Exclusive prefix sum in (bucket, chunk) order gives every chunk its write position per bucket
+    std::vector<size_t> offsets(numChunks * numBuckets);
+    std::vector<size_t> bucketStart(numBuckets + 1);
+    size_t running = 0;
+    for (size_t b = 0; b < numBuckets; ++b) {
+        bucketStart[b] = running;
+        for (size_t c = 0; c < numChunks; ++c) {
+            offsets[c * numBuckets + b] = running;
+            running += counts[c * numBuckets + b];
+        }
+    }
+    bucketStart[numBuckets] = n;
+
+    // 4. Scatter into the buckets
+    std::vector<Edge> sorted(n, Edge(0, 0, 0));
+    pool.parallelFor(numChunks, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t c = firstChunk; c < lastChunk; ++c) {
+            size_t* offset = &offsets[c * numBuckets];
+            for (size_t i = c * n / numChunks; i < (c + 1) * n / numChunks; ++i) {
+                sorted[offset[bucketOf[i]]++] = edges[i];
+            }
+        }
+    });
+
+    // 5. Sort the buckets independently
+    pool.parallelFor(numBuckets, [&](size_t firstBucket, size_t lastBucket) {
+        for (size_t b = firstBucket; b < lastBucket; ++b) {
+            std::sort(sorted.begin() + bucketStart[b], sorted.begin() + bucketStart[b + 1], edgeLess);
+        }
+    });
+
+    edges.swap(sorted);
+}
+
+// ---------------------------- Parallel Kruskal ----------------------------
+// Root of i without path compression, safe to run from many threads while nobody writes parent
+static int findRoot(const std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        i = parent[i];
+    }
+    return i;
+}
+
+ParallelKruskalSolver::ParallelKruskalSolver(ThreadPool& pool) : pool(pool) {}
+
+std::vector<Edge> ParallelKruskalSolver::solve(const Graph& graph) {
+    std::vector<Edge> mstEdges = spanningForest(graph);
+    // Same contract as the other solvers: no spanning tree for a disconnected graph
+    if (graph.getNumVertices() > 0 && mstEdges.size() != static_cast<size_t>(graph.getNumVertices() - 1)) {
+        return {};
+    }
+    return mstEdges;
+}
+
+std::vector<Edge> ParallelKruskalSolver::spanningForest(const Graph& graph) {
+    int numVertices = graph.getNumVertices();
+
+    // Each undirected edge once, sorted by weight
+    std::vector<Edge> edges;
+    for (const Edge& edge : graph.getEdges()) {
+        if (edge.u < edge.v) {
+            edges.push_back(edge);
+        }
+    }
+    parallelSortEdges(edges, pool);
+
+    std::vector<int> parent(numVertices);
+    std::vector<int> rank(numVertices, 0);
+    for (int i = 0; i < numVertices; ++i) {
+        parent[i] = i;
+    }
+
+    size_t target = numVertices > 0 ? numVertices - 1 : 0;
+    std::vector<Edge> mstEdges;
+    mstEdges.reserve(target);
+
+    // Process the sorted edges in blocks of doubling size. Before the sequential union pass of a
+    // block, a parallel pre-filter drops the edges whose endpoints are already connected in the DSU
+    // as it was at the start of the block. Later blocks are mostly such edges, so the sequential
+    // pass only sees a small fraction of them.
+    std::vector<char> keep(edges.size(), 1);
+    size_t pos = 0;
+    size_t block = std::max<size_t>(numVertices, 1024);
+    while (pos < edges.size() && mstEdges.size() < target) {
+        size_t end = std::min(edges.size(), pos + block);
+
+        if (pos > 0) {
+            // The DSU is only read here, so the threads can share it without locking
+            pool.parallelFor(end - pos, [&](size_t begin, size_t last) {
+                for (size_t i = pos + begin; i < pos + last; ++i) {
+                    keep[i] = findRoot(parent, edges[i].u) != findRoot(parent, edges[i].v);
+                }
+            });
+        }
+
+        for (size_t i = pos; i < end && mstEdges.size() < target; ++i) {
+            if (!keep[i]) {
+                continue;
+            }
+            int setU = find(parent, edges[i].u);
+            int setV = find(parent, edges[i].v);
+            if (setU != setV) {
+                mstEdges.push_back(edges[i]);
+                unionSets(parent, rank, setU, setV);
+            }
+        }
+
+        pos = end;
+        block *= 2;
+    }
+
+    return mstEdges;
+}
@@ -0,0 +1,441 @@
+#include "TreeMetrics.hpp"
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+// Parallel version of computeMetrics() for large trees. Everything runs on the pool in a
+// constant number of passes over the arcs, the only sequential parts are O(number of chunks)
+// or O(number of sublists):
+//  1. edge stats with per-chunk weight histograms, degrees (atomic counters), parallel prefix
+//     sum -> CSR with twin arcs
+//  2. Euler tour successor of every arc: the arc after the twin in the target's adjacency
+//  3. list ranking with sublists: walk from a few hundred splitters in parallel, rank the
+//     sublists sequentially, then add the offsets in parallel
+//  4. arc u->v is a tree edge downwards iff it comes before its twin in the tour, and the
+//     subtree below it has (rank(twin) - rank(arc) + 1) / 2 vertices -> Wiener index
+//  5. depths along the tour come from a parallel prefix sum of +w / -w, and the diameter is
+//     max over i <= j <= k of X[i] - 2 X[j] + X[k], folded per chunk with a small monoid
+//  6. with non-negative weights the farthest vertex from any vertex is one of the two diameter
+//     ends (tour positions i and k of the fold), and the depth of lca(u, v) is the smallest depth
+//     between u and v in the tour, so two parallel running minima from i and k give every eccentricity
+
+// Run body(chunk, begin, end) for numChunks equal slices of [0, n)
+static void forEachChunk(ThreadPool& pool, size_t numChunks, size_t n, const std::function<void(size_t, size_t, size_t)>& body) {
+    pool.parallelFor(numChunks, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            body(c, c * n / numChunks, (c + 1) * n / numChunks);
+        }
+    });
+}
+
+// In-place inclusive prefix sum: per-chunk sums, sequential scan over the chunks, then every chunk
+// rescans itself with its offset
+template <typename T>
+static void parallelInclusiveScan(ThreadPool& pool, size_t numChunks, std::vector<T>& values) {
+    std::vector<T> chunkSum(numChunks, 0);
+    forEachChunk(pool, numChunks, values.size(), [&](size_t c, size_t begin, size_t end) {
+        T sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+            sum += values[i];
+        }
+        chunkSum[c] = sum;
+    });
+    T running = 0;
+    for (size_t c = 0; c < numChunks; ++c) {
+        T sum = chunkSum[c];
+        chunkSum[c] = running;
+        running += sum;
+    }
+    forEachChunk(pool, numChunks, values.size(), [&](size_t c, size_t begin, size_t end) {
+        T sum = chunkSum[c];
+        for (size_t i = begin; i < end; ++i) {
+            sum += values[i];
+            values[i] = sum;
+        }
+    });
+}
+
+// Running minimum of values over the tour positions between anchor and i (both included), in out[i]:
+// a forward scan from the anchor to the end and a backward scan from the anchor to the start
+static void minFromAnchor(ThreadPool& pool, size_t numChunks, const std::vector<long long>& values, size_t anchor,
+                          std::vector<long long>& out) {
+    auto scan = [&](size_t length, const std::function<size_t(size_t)>& position) {
+        std::vector<long long> chunkMin(numChunks, LLONG_MAX);
+        forEachChunk(pool, numChunks, length, [&](size_t c, size_t begin, size_t end) {
+            long long low = LLONG_MAX;
+            for (size_t j = begin; j < end; ++j) {
+                low = std::min(low, values[position(j)]);
+            }
+            chunkMin[c] = low;
+        });
+        long long running = LLONG_MAX;
+        for (size_t c = 0; c < numChunks; ++c) {
+            long long low = chunkMin[c];
+            chunkMin[c] = running;
+            running = std::min(running, low);
+        }
+        forEachChunk(pool, numChunks, length, [&](size_t c, size_t begin, size_t end) {
+            long long low = chunkMin[c];
+            for (size_t j = begin; j < end; ++j) {
+                size_t i = position(j);
+                low = std::min(low, values[i]);
+                out[i] = low;
+            }
+        });
+    };
+    scan(values.size() - anchor, [anchor](size_t j) { return anchor + j; });
+    scan(anchor + 1, [anchor](size_t j) { return anchor - j; });
+}
+
+// max over i <= j <= k of X[i] - 2 X[j] + X[k] for a segment of the depth sequence,
+// with the positions reaching every maximum
+struct DiameterFold {
+    static constexpr long long NONE = LLONG_MIN / 4;
+    long long a = NONE;        // max X[i]
+    long long b = NONE;        // max -2 X[j]
+    long long ab = NONE;       // max X[i] - 2 X[j], i <= j
+    long long bc = NONE;       // max -2 X[j] + X[k], j <= k
+    long long abc = NONE;      // max X[i] - 2 X[j] + X[k], i <= j <= k
+    size_t aAt = 0;            // i of a
+    size_t abAt = 0;           // i of ab
+    size_t bcAt = 0;           // k of bc
+    size_t abcFrom = 0;        // i and k of abc
+    size_t abcTo = 0;
+
+    void push(long long x, size_t position);
+};
+
+static DiameterFold combine(const DiameterFold& l, const DiameterFold& r) {
+    DiameterFold f = l;
+    if (r.a > f.a) {
+        f.a = r.a;
+        f.aAt = r.aAt;
+    }
+    f.b = std::max(l.b, r.b);
+    if (r.ab > f.ab) {
+        f.ab = r.ab;
+        f.abAt = r.abAt;
+    }
+    if (l.a + r.b > f.ab) {
+        f.ab = l.a + r.b;
+        f.abAt = l.aAt;
+    }
+    if (r.bc > f.bc) {
+        f.bc = r.bc;
+        f.bcAt = r.bcAt;
+    }
+    if (l.b + r.a > f.bc) {
+        f.bc = l.b + r.a;
+        f.bcAt = r.aAt;
+    }
+    if (r.abc > f.abc) {
+        f.abc = r.abc;
+        f.abcFrom = r.abcFrom;
+        f.abcTo = r.abcTo;
+    }
+    if (l.ab + r.a > f.abc) {
+        f.abc = l.ab + r.a;
+        f.abcFrom = l.abAt;
+        f.abcTo = r.aAt;
+    }
+    if (l.a + r.bc > f.abc) {
+        f.abc = l.a + r.bc;
+        f.abcFrom = l.aAt;
+        f.abcTo = r.bcAt;
+    }
+    return f;
+}
+
+// combine(*this, single element x), where a single element has a = x, b = -2x, ab = bc = -x, abc = 0
+void DiameterFold::push(long long x, size_t position) {
+    DiameterFold single;
+    single.a = x;
+    single.b = -2 * x;
+    single.ab = single.bc = -x;
+    single.abc = 0;
+    single.aAt = single.abAt = single.bcAt = single.abcFrom = single.abcTo = position;
+    *this = combine(*this, single);
+}
+
+MetricsResult computeMetricsParallel(const std::vector<Edge>& tree, ThreadPool& pool) {
+    MetricsResult metrics;
+    if (tree.empty()) {
+        return metrics;
+    }
+    size_t m = tree.size();
+    size_t numChunks = pool.size() + 1;
+
+    // ---- 1. Edge stats, degrees and CSR ----
+    struct EdgeStats {
+        int maxId = -1;
+        long long total = 0;
+        int minWeight = INT_MAX;
+        int maxWeight = INT_MIN;
+        WeightHistogram histogram;
+    };
+    std::vector<EdgeStats> edgeStats(numChunks);
+    forEachChunk(pool, numChunks, m, [&](size_t c, size_t begin, size_t end) {
+        EdgeStats stats;
+        for (size_t i = begin; i < end; ++i) {
+            stats.maxId = std::max({stats.maxId, tree[i].u, tree[i].v});
+            stats.total += tree[i].weight;
+            stats.minWeight = std::min(stats.minWeight, tree[i].weight);
+            stats.maxWeight = std::max(stats.maxWeight, tree[i].weight);
+            stats.histogram.record(tree[i].weight);
+        }
+        edgeStats[c] = stats;
+    });
+    EdgeStats stats;
+    for (const EdgeStats& chunk : edgeStats) {
+        stats.maxId = std::max(stats.maxId, chunk.maxId);
+        stats.total += chunk.total;
+        stats.minWeight = std::min(stats.minWeight, chunk.minWeight);
+        stats.maxWeight = std::max(stats.maxWeight, chunk.maxWeight);
+        stats.histogram.merge(chunk.histogram);
+    }
+    int n = stats.maxId + 1;
+    if (stats.minWeight < 0) {
+        // the farthest vertex is not always a diameter end with negative weights (step 6)
+        return computeMetrics(tree, SIZE_MAX);
+    }
+
+    std::vector<int> start(n + 1, 0);
+    forEachChunk(pool, numChunks, m, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            __atomic_fetch_add(&start[tree[i].u + 1], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&start[tree[i].v + 1], 1, __ATOMIC_RELAXED);
+        }
+    });
+    parallelInclusiveScan(pool, numChunks, start);
+
+    // A vertex without any edge means this is not a single tree, the sequential version handles forests
+    if (start[1] == 0) {
+        return computeMetrics(tree, SIZE_MAX);
+    }
+
+    size_t numArcs = 2 * m;
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    std::vector<int> arcTarget(numArcs), arcWeight(numArcs), twin(numArcs);
+    forEachChunk(pool, numChunks, m, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Edge& edge = tree[i];
+            int forward = __atomic_fetch_add(&fill[edge.u], 1, __ATOMIC_RELAXED);
+            int backward = __atomic_fetch_add(&fill[edge.v], 1, __ATOMIC_RELAXED);
+            arcTarget[forward] = edge.v;
+            arcWeight[forward] = edge.weight;
+            twin[forward] = backward;
+            arcTarget[backward] = edge.u;
+            arcWeight[backward] = edge.weight;
+            twin[backward] = forward;
+        }
+    });
+
+    // ---- 2. Euler tour successors, the cycle is cut before the first arc of vertex 0 ----
+    std::vector<int> succ(numArcs);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t, size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            int v = arcTarget[a];
+            int next = twin[a] + 1;
+            succ[a] = next < start[v + 1] ? next : start[v];
+        }
+    });
+    int head = start[0];
+    succ[twin[start[1] - 1]] = -1;
+
+    // ---- 3. List ranking ----
+    size_t stride = std::max<size_t>(1, numArcs / (numChunks * 64));
+    std::vector<int> splitters;
+    splitters.push_back(head);
+    for (size_t a = 0; a < numArcs; a += stride) {
+        if (static_cast<int>(a) != head) {
+            splitters.push_back(static_cast<int>(a));
+        }
+    }
+    size_t numSublists = splitters.size();
+    std::vector<int> sublistOf(numArcs, -1);
+    std::vector<int> localRank(numArcs);
+    for (size_t s = 0; s < numSublists; ++s) {
+        sublistOf[splitters[s]] = static_cast<int>(s);
+    }
+    std::vector<int> sublistLength(numSublists), nextSublist(numSublists);
+    forEachChunk(pool, numChunks, numSublists, [&](size_t, size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            int a = splitters[s];
+            localRank[a] = 0;
+            int length = 1;
+            a = succ[a];
+            // the splitters' entries of sublistOf were written before, other walkers only read them
+            while (a != -1 && sublistOf[a] == -1) {
+                sublistOf[a] = static_cast<int>(s);
+                localRank[a] = length++;
+                a = succ[a];
+            }
+            sublistLength[s] = length;
+            nextSublist[s] = a == -1 ? -1 : sublistOf[a];
+        }
+    });
+    std::vector<int> sublistOffset(numSublists, 0);
+    size_t ranked = 0;
+    for (int s = 0; s != -1; s = nextSublist[s]) {
+        sublistOffset[s] = static_cast<int>(ranked);
+        ranked += sublistLength[s];
+        if (ranked > numArcs) {
+            break;
+        }
+    }
+    if (ranked != numArcs) {
+        // the tour from vertex 0 does not cover every arc: a forest, not a tree
+        return computeMetrics(tree, SIZE_MAX);
+    }
+    std::vector<int> rank(numArcs);
+    std::vector<int> tour(numArcs);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t, size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            rank[a] = sublistOffset[sublistOf[a]] + localRank[a];
+            tour[rank[a]] = static_cast<int>(a);
+        }
+    });
+
+    // ---- 4. Subtree sizes from the tour -> pairwise distance sum ----
+    std::vector<long long> chunkPairwise(numChunks, 0);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t c, size_t begin, size_t end) {
+        long long sum = 0;
+        for (size_t a = begin; a < end; ++a) {
+            int back = twin[a];
+            if (rank[a] < rank[back]) {
+                long long size = (rank[back] - rank[a] + 1) / 2;
+                sum += arcWeight[a] * size * (n - size);
+            }
+        }
+        chunkPairwise[c] = sum;
+    });
+
+    // ---- 5. Depths along the tour -> diameter ----
+    std::vector<long long> chunkDepth(numChunks, 0);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t c, size_t begin, size_t end) {
+        long long depth = 0;
+        for (size_t i = begin; i < end; ++i) {
+            int a = tour[i];
+            depth += rank[a] < rank[twin[a]] ? arcWeight[a] : -arcWeight[a];
+        }
+        chunkDepth[c] = depth;
+    });
+    long long running = 0;
+    for (size_t c = 0; c < numChunks; ++c) {
+        long long depth = chunkDepth[c];
+        chunkDepth[c] = running;
+        running += depth;
+    }
+    // depth[i] is the depth after i arcs of the tour, depth[0] = 0 at the root
+    std::vector<long long> depth(numArcs + 1);
+    depth[0] = 0;
+    std::vector<DiameterFold> chunkFold(numChunks);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t c, size_t begin, size_t end) {
+        DiameterFold fold;
+        long long current = chunkDepth[c];
+        if (c == 0) {
+            fold.push(0, 0);      // the root, before the first arc
+        }
+        for (size_t i = begin; i < end; ++i) {
+            int a = tour[i];
+            current += rank[a] < rank[twin[a]] ? arcWeight[a] : -arcWeight[a];
+            depth[i + 1] = current;
+            fold.push(current, i + 1);
+        }
+        chunkFold[c] = fold;
+    });
+
+    // ---- Degree stats ----
+    struct DegreeStats {
+        int minDegree = INT_MAX;
+        int maxDegree = 0;
+        int leaves = 0;
+    };
+    std::vector<DegreeStats> degreeStats(numChunks);
+    forEachChunk(pool, numChunks, n, [&](size_t c, size_t begin, size_t end) {
+        DegreeStats degrees;
+        for (size_t v = begin; v < end; ++v) {
+            int degree = start[v + 1] - start[v];
+            degrees.minDegree = std::min(degrees.minDegree, degree);
+            degrees.maxDegree = std::max(degrees.maxDegree, degree);
+            degrees.leaves += degree == 1;
+        }
+        degreeStats[c] = degrees;
+    });
+
+    // ---- Combine the per-chunk results ----
+    metrics.numVertices = n;
+    metrics.numEdges = static_cast<int>(m);
+    metrics.totalWeight = stats.total;
+    metrics.minEdgeWeight = stats.minWeight;
+    metrics.maxEdgeWeight = stats.maxWeight;
+    metrics.weightHistogram = stats.histogram;
+    DiameterFold fold;
+    metrics.minDegree = INT_MAX;
+    for (size_t c = 0; c < numChunks; ++c) {
+        metrics.pairwiseDistanceSum += chunkPairwise[c];
+        fold = combine(fold, chunkFold[c]);
+        metrics.minDegree = std::min(metrics.minDegree, degreeStats[c].minDegree);
+        metrics.maxDegree = std::max(metrics.maxDegree, degreeStats[c].maxDegree);
+        metrics.numLeaves += degreeStats[c].leaves;
+    }
+    if (metrics.minDegree == 0) {
+        // an id without edges: the tour covers a tree on fewer than n vertices
+        return computeMetrics(tree, SIZE_MAX);
+    }
+    metrics.diameter = fold.abc;
+
+    // ---- 6. Eccentricities from the two diameter ends ----
+    // first tour position of every vertex: the root is at 0, any other vertex right after its down arc
+    std::vector<int> firstPosition(n, 0);
+    forEachChunk(pool, numChunks, numArcs, [&](size_t, size_t begin, size_t end) {
+        for (size_t a = begin; a < end; ++a) {
+            if (rank[a] < rank[twin[a]]) {
+                firstPosition[arcTarget[a]] = rank[a] + 1;
+            }
+        }
+    });
+    std::vector<long long> eccentricity(n, 0);
+    std::vector<long long> lcaDepth(numArcs + 1);
+    for (size_t end : {fold.abcFrom, fold.abcTo}) {
+        minFromAnchor(pool, numChunks, depth, end, lcaDepth);
+        forEachChunk(pool, numChunks, n, [&](size_t, size_t begin, size_t last) {
+            for (size_t v = begin; v < last; ++v) {
+                int position = firstPosition[v];
+                long long distance = depth[position] + depth[end] - 2 * lcaDepth[position];
+                eccentricity[v] = std::max(eccentricity[v], distance);
+            }
+        });
+    }
+    std::vector<long long> chunkRadius(numChunks, LLONG_MAX);
+    forEachChunk(pool, numChunks, n, [&](size_t c, size_t begin, size_t end) {
+        long long radius = LLONG_MAX;
+        for (size_t v = begin; v < end; ++v) {
+            radius = std::min(radius, eccentricity[v]);
+        }
+        chunkRadius[c] = radius;
+    });
+    metrics.radius = *std::min_element(chunkRadius.begin(), chunkRadius.end());
+    std::vector<std::vector<int>> chunkHistogram(numChunks, std::vector<int>(ECCENTRICITY_BUCKETS, 0));
+    std::vector<std::vector<int>> chunkCenters(numChunks);
+    forEachChunk(pool, numChunks, n, [&](size_t c, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            chunkHistogram[c][eccentricityBucket(eccentricity[v], metrics.radius, metrics.diameter)]++;
+            if (eccentricity[v] == metrics.radius) {
+                chunkCenters[c].push_back(static_cast<int>(v));
+            }
+        }
+    });
+    metrics.eccentricityHistogram.assign(ECCENTRICITY_BUCKETS, 0);
+    for (size_t c = 0; c < numChunks; ++c) {
+        for (int b = 0; b < ECCENTRICITY_BUCKETS; ++b) {
+            metrics.eccentricityHistogram[b] += chunkHistogram[c][b];
+        }
+        metrics.centers.insert(metrics.centers.end(), chunkCenters[c].begin(), chunkCenters[c].end());
+    }
+
+    long long numPairs = static_cast<long long>(n) * (n + 1) / 2;
+    metrics.averageDistance = static_cast<double>(metrics.pairwiseDistanceSum) / numPairs;
+    metrics.averageDegree = 2.0 * m / n;
+    return metrics;
+}
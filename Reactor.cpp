@@ -0,0 +1,319 @@
+#include "Reactor.hpp"
+#include "WireProtocol.hpp"
+#include <iostream>
+#include <chrono>
+#include <exception>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#define MAX_EVENTS 256
+#define READ_CHUNK 65536
+#define POLL_INTERVAL_MS 1000
+#define MAX_PIPELINE_DEPTH 64           // replies a connection may have outstanding
+#define OUT_HIGH_WATER (1 << 20)        // no new commands while this much reply data waits
+#define IN_HIGH_WATER (1 << 20)         // no more reading while this much input waits for dispatch
+
+// Allow as many descriptors as the hard limit, the default soft limit (1024) is far too low
+// for many idle clients
+static void raiseFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+Reactor::Connection::Connection(int socket, GraphRegistry& graphs, const SolvePipeline* pipeline)
+    : socket(socket), session(graphs, pipeline), outSent(0), firstSequence(0), inFlight(0), barrier(false),
+      holding(false), peerClosed(false), readPaused(false) {}
+
+Reactor::Reactor(int listenSocket, GraphRegistry& graphs, size_t numWorkers)
+    : listenSocket(listenSocket), graphs(graphs), numConnections(0), workers(numWorkers) {
+    raiseFileLimit();
+    fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL, 0) | O_NONBLOCK);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = listenSocket;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenSocket, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+Reactor::~Reactor() {
+    for (std::unique_ptr<Connection>& connection : connections) {
+        if (connection) {
+            close(connection->socket);
+        }
+    }
+    close(spareFd);
+    close(wakeFd);
+    close(epollFd);
+    close(listenSocket);
+}
+
+void Reactor::run(int idleSeconds) {
+    std::vector<epoll_event> events(MAX_EVENTS);
+    auto lastActivity = std::chrono::steady_clock::now();
+
+    while (true) {
+        int ready = epoll_wait(epollFd, events.data(), MAX_EVENTS, POLL_INTERVAL_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenSocket) {
+                acceptAll();
+            } else if (fd == wakeFd) {
+                drainCompletions();
+            } else if (fd < static_cast<int>(connections.size()) && connections[fd]) {
+                Connection& connection = *connections[fd];
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    readAll(connection);
+                }
+                if ((events[i].events & EPOLLOUT) && !flush(connection)) {
+                    closeConnection(fd);
+                    continue;
+                }
+                dispatch(connection);
+                resumeReading(connection);
+                closeWhenDone(connection);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (numConnections > 0) {
+            lastActivity = now;
+        } else if (std::chrono::duration_cast<std::chrono::seconds>(now - lastActivity).count() >= idleSeconds) {
+            std::cout << "No connections for " << idleSeconds << " seconds. Exiting...\n";
+            break;
+        }
+    }
+}
+
+// Edge triggered: accept until the backlog is empty, there is no second notification
+void Reactor::acceptAll() {
+    while (true) {
+        int client = accept4(listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE) {
+                // out of descriptors: free the spare one to take the client off the backlog and
+                // close it, otherwise it would stay there without another notification
+                std::cerr << "accept: out of file descriptors, dropping a client\n";
+                close(spareFd);
+                close(accept(listenSocket, nullptr, nullptr));
+                spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+            }
+            return;
+        }
+
+        if (client >= static_cast<int>(connections.size())) {
+            connections.resize(client + 1);
+        }
+        connections[client].reset(new Connection(client, graphs, &pipeline));
+        numConnections++;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.fd = client;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &event);
+        std::cout << "Client connected, socket " << client << std::endl;
+    }
+}
+
+// Read until the socket has nothing more, everything goes to the framer. A client that sends
+// faster than its commands can be dispatched is left in the socket above IN_HIGH_WATER; a command
+// that is not complete yet is always read on (the framer bounds it)
+void Reactor::readAll(Connection& connection) {
+    char buffer[READ_CHUNK];
+    while (!connection.peerClosed) {
+        if (connection.framer.buffered() >= IN_HIGH_WATER && !dispatch(connection)) {
+            connection.readPaused = true;
+            return;
+        }
+        ssize_t bytesReceived = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (bytesReceived > 0) {
+            connection.framer.feed(buffer, bytesReceived);
+        } else if (bytesReceived < 0 && errno == EINTR) {
+            continue;
+        } else if (bytesReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            connection.peerClosed = true;
+        }
+    }
+}
+
+// Write as much of the pending reply as the socket takes, false if the connection broke
+bool Reactor::flush(Connection& connection) {
+    while (connection.outSent < connection.outBuffer.size()) {
+        ssize_t sent = send(connection.socket, connection.outBuffer.data() + connection.outSent,
+                            connection.outBuffer.size() - connection.outSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;    // EPOLLOUT tells when to go on
+        }
+        connection.outSent += sent;
+    }
+    connection.outBuffer.clear();
+    connection.outSent = 0;
+    return true;
+}
+
+// Start the complete commands of the connection, as many as the pipeline allows. A command cut
+// short by the end of a segment waits for the rest, only a client that hung up ends it (see CommandFramer).
+// True if it stopped for want of a complete command, false if the limits of the connection stopped it
+bool Reactor::dispatch(Connection& connection) {
+    while (!connection.barrier && connection.replies.size() < MAX_PIPELINE_DEPTH
+           && connection.outBuffer.size() - connection.outSent < OUT_HIGH_WATER) {
+        if (!connection.holding && !connection.framer.nextCommand(connection.held, connection.peerClosed)) {
+            return true;
+        }
+        connection.holding = true;
+        // no command is classified while one that changes state runs, expectsEdges is settled
+        bool mutation = connection.session.mutates(connection.held, connection.framer.isBinary());
+        if (mutation && connection.inFlight > 0) {
+            return false;   // started when the commands before it completed
+        }
+        connection.holding = false;
+        start(connection, connection.held, mutation);
+    }
+    return false;
+}
+
+// Edge triggered: what was left in the socket when reading paused gives no new notification, so
+// it is read once dispatch may have made room (readAll pauses again if it did not)
+void Reactor::resumeReading(Connection& connection) {
+    if (connection.readPaused) {
+        connection.readPaused = false;
+        readAll(connection);
+        dispatch(connection);
+    }
+}
+
+// Give the command a reply slot and hand it to the pipeline or a worker
+void Reactor::start(Connection& connection, const std::string& command, bool mutation) {
+    uint64_t sequence = connection.firstSequence + connection.replies.size();
+    connection.replies.push_back(Reply{false, ""});
+    connection.inFlight++;
+    connection.barrier = mutation;
+    int socket = connection.socket;
+    bool binary = connection.framer.isBinary();
+    // a text frame of the binary protocol carries the same commands
+    std::string_view text = !binary ? std::string_view(command)
+                          : !command.empty() && command[0] == FRAME_TEXT ? std::string_view(command).substr(1) : "";
+    // a graph that is gone is reported by the session
+    std::shared_ptr<NamedGraph> graph;
+    if (!connection.session.expectsEdges() && SolvePipeline::handles(text) && (graph = connection.session.currentGraph())) {
+        pipeline.submit(std::string(text), graph, [this, socket, sequence, binary](const std::string& response) {
+            complete(socket, sequence, binary ? encodeFrame(REPLY_OK, response) : response);
+        });
+        return;
+    }
+    ClientSession* session = &connection.session;
+    workers.enqueue([this, socket, sequence, session, binary, command] {
+        std::string response;
+        try {
+            response = binary ? session->executeFrame(command) : session->execute(command);
+        } catch (const std::exception& e) {
+            std::cerr << "Command failed: " << e.what() << "\n";
+            response = binary ? encodeFrame(REPLY_ERROR, "") : "";
+        }
+        complete(socket, sequence, response);
+    });
+}
+
+// Called by the workers and the pipeline: queue the reply and wake the loop
+void Reactor::complete(int socket, uint64_t sequence, const std::string& response) {
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        completions.push_back(Completion{socket, sequence, response});
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;      // the counter only saturates, the loop is woken either way
+}
+
+void Reactor::drainCompletions() {
+    uint64_t count;
+    while (read(wakeFd, &count, sizeof(count)) > 0) {
+    }
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        done.swap(completions);
+    }
+    for (Completion& completion : done) {
+        // a connection with commands in flight is never closed, so the socket still belongs to it
+        Connection& connection = *connections[completion.socket];
+        Reply& reply = connection.replies[completion.sequence - connection.firstSequence];
+        reply.done = true;
+        reply.response.swap(completion.response);
+        connection.inFlight--;
+        if (connection.inFlight == 0) {
+            connection.barrier = false;
+        }
+
+        // the replies that are done and have every earlier one written go out
+        while (!connection.replies.empty() && connection.replies.front().done) {
+            connection.outBuffer += connection.replies.front().response;
+            connection.replies.pop_front();
+            connection.firstSequence++;
+        }
+        if (!flush(connection)) {
+            closeConnection(completion.socket);
+            continue;
+        }
+        dispatch(connection);
+        resumeReading(connection);
+        closeWhenDone(connection);
+    }
+}
+
+// A client that hung up is closed once its last command ran and the reply went out
+void Reactor::closeWhenDone(Connection& connection) {
+    if (!connection.peerClosed || connection.inFlight > 0 || !connection.outBuffer.empty()) {
+        return;
+    }
+    dispatch(connection);
+    if (connection.inFlight == 0) {
+        closeConnection(connection.socket);
+    }
+}
+
+void Reactor::closeConnection(int socket) {
+    if (connections[socket]->inFlight > 0) {
+        connections[socket]->peerClosed = true;    // closed when its commands complete
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+    close(socket);
+    connections[socket].reset();
+    numConnections--;
+    std::cout << "Client disconnected.\n";
+}
@@ -0,0 +1,94 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <mutex>
+#include "GraphRegistry.hpp"
+#include "ServerSession.hpp"
+#include "ThreadPool.hpp"
+#include "SolvePipeline.hpp"
+
+// Non-blocking, edge-triggered epoll event loop that owns every socket of the server.
+// The loop thread accepts, reads and writes; only complete commands go to the worker pool, so an
+// idle connection costs a few hundred bytes of state instead of a parked thread.
+//
+// Connections are pipelined: a client may send many commands without waiting for the replies.
+// Commands that only read run in parallel, up to MAX_PIPELINE_DEPTH per connection, while a
+// command that changes the graph or the session (see ClientSession::mutates) runs alone - after
+// everything sent before it and before everything sent after it. Every command gets a sequence
+// number and a reply slot, and the replies are written out in sequence order whatever order they
+// complete in. Workers hand the replies back through a completion queue and wake the loop with an
+// eventfd; the loop writes as much as the socket takes and waits for EPOLLOUT for the rest. MST
+// commands go to the solve pipeline instead of the pool and come back the same way. Input that
+// cannot be dispatched is not read beyond a high-water mark, so a client that never reads its
+// replies is held back by TCP flow control instead of growing the server's buffers.
+class Reactor {
+public:
+    // listenSocket must be bound and listening, it is made non-blocking and owned by the reactor
+    Reactor(int listenSocket, GraphRegistry& graphs, size_t numWorkers);
+    ~Reactor();
+
+    // Serve until there were no connections for idleSeconds
+    void run(int idleSeconds);
+
+private:
+    struct Reply {
+        bool done;
+        std::string response;
+    };
+
+    struct Connection {
+        Connection(int socket, GraphRegistry& graphs, const SolvePipeline* pipeline);
+        int socket;
+        CommandFramer framer;
+        ClientSession session;
+        std::string outBuffer;      // reply bytes the socket did not take yet
+        size_t outSent;
+        std::deque<Reply> replies;  // of the commands dispatched and not written out, in order
+        uint64_t firstSequence;     // sequence number of replies.front()
+        size_t inFlight;            // commands on the pool or the pipeline
+        bool barrier;               // the one in flight changes state, nothing else may start
+        std::string held;           // taken from the framer, waits for the commands before it
+        bool holding;
+        bool peerClosed;
+        bool readPaused;            // input left in the socket above IN_HIGH_WATER
+    };
+
+    struct Completion {
+        int socket;
+        uint64_t sequence;
+        std::string response;
+    };
+
+    void acceptAll();
+    void readAll(Connection& connection);
+    bool flush(Connection& connection);
+    bool dispatch(Connection& connection);
+    void resumeReading(Connection& connection);
+    void start(Connection& connection, const std::string& command, bool mutation);
+    void complete(int socket, uint64_t sequence, const std::string& response);
+    void drainCompletions();
+    void closeWhenDone(Connection& connection);
+    void closeConnection(int socket);
+
+    int listenSocket;
+    int epollFd;
+    int wakeFd;
+    int spareFd;                    // given up to accept (and drop) a client when out of descriptors
+    GraphRegistry& graphs;
+    std::vector<std::unique_ptr<Connection>> connections;   // by socket
+    size_t numConnections;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    // last, so they stop before the state their tasks use goes away
+    ThreadPool workers;
+    SolvePipeline pipeline;
+};
+
+#endif // REACTOR_HPP
@@ -0,0 +1,89 @@
+#include "ResultCache.hpp"
+
+std::string algorithmName(MSTFactory::MSTType type) {
+    switch (type) {
+        case MSTFactory::BORUVKA:
+            return "Boruvka";
+        case MSTFactory::PRIM:
+            return "Prim";
+        case MSTFactory::PARALLEL_KRUSKAL:
+            return "Kruskal";
+    }
+    return "";
+}
+
+std::shared_ptr<const SolveResult> makeSolveResult(std::vector<Edge> mst, MSTFactory::MSTType type) {
+    MetricsResult metrics = computeMetrics(mst);
+    return makeSolveResult(std::move(mst), std::move(metrics), type);
+}
+
+std::shared_ptr<const SolveResult> makeSolveResult(std::vector<Edge> mst, MetricsResult metrics, MSTFactory::MSTType type) {
+    std::shared_ptr<SolveResult> result = std::make_shared<SolveResult>();
+    result->mst = std::move(mst);
+    result->metrics = std::move(metrics);
+    result->response = "Minimum Spanning Tree (" + algorithmName(type) + "):\n";
+    for (const Edge& edge : result->mst) {
+        result->response += std::to_string(edge.u) + " <-> " + std::to_string(edge.v) + " (" + std::to_string(edge.weight) + ")\n";
+    }
+    result->response += printMetrics(result->metrics);
+    return result;
+}
+
+std::shared_ptr<const SolveResult> ResultCache::find(unsigned long long generation, MSTFactory::MSTType type) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = entries.find(type);
+    if (it == entries.end() || it->second.generation != generation) {
+        return nullptr;
+    }
+    return it->second.result;
+}
+
+void ResultCache::store(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result) {
+    std::lock_guard<std::mutex> lock(mtx);
+    storeLocked(generation, type, std::move(result));
+}
+
+void ResultCache::storeLocked(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result) {
+    auto it = entries.find(type);
+    if (it != entries.end() && it->second.generation > generation) {
+        return;     // solved from an older graph while a newer result was stored
+    }
+    entries[type] = Entry{generation, std::move(result)};
+}
+
+ResultCache::Flight ResultCache::join(unsigned long long generation, MSTFactory::MSTType type) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto cached = entries.find(type);
+    if (cached != entries.end() && cached->second.generation == generation) {
+        std::promise<std::shared_ptr<const SolveResult>> ready;
+        ready.set_value(cached->second.result);
+        return Flight{ready.get_future().share(), false};
+    }
+    Key key(type, generation);
+    auto running = inFlight.find(key);
+    if (running != inFlight.end()) {
+        return Flight{running->second.result, false};
+    }
+    InFlight& flight = inFlight[key];
+    flight.result = flight.promise.get_future().share();
+    return Flight{flight.result, true};
+}
+
+void ResultCache::complete(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = inFlight.find(Key(type, generation));
+    if (it != inFlight.end()) {
+        it->second.promise.set_value(result);
+        inFlight.erase(it);
+    }
+    storeLocked(generation, type, std::move(result));
+}
+
+void ResultCache::abandon(unsigned long long generation, MSTFactory::MSTType type, std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = inFlight.find(Key(type, generation));
+    if (it != inFlight.end()) {
+        it->second.promise.set_exception(error);
+        inFlight.erase(it);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <future>
+#include <exception>
+#include <utility>
+#include "Graph.hpp"
+#include "MSTFactory.hpp"
+#include "TreeMetrics.hpp"
+
+// Everything a solve request produces, kept immutable once built so it can be shared
+struct SolveResult {
+    std::vector<Edge> mst;
+    MetricsResult metrics;
+    std::string response;       // text sent to the clients
+};
+
+// Name of the algorithm in the responses
+std::string algorithmName(MSTFactory::MSTType type);
+
+// Metrics and response text of a solved MST
+std::shared_ptr<const SolveResult> makeSolveResult(std::vector<Edge> mst, MSTFactory::MSTType type);
+// Same, with the metrics already computed
+std::shared_ptr<const SolveResult> makeSolveResult(std::vector<Edge> mst, MetricsResult metrics, MSTFactory::MSTType type);
+
+// Solve results of one graph per (generation, algorithm); every graph of the registry has its own
+// (NamedGraph::results). The generation of a graph only grows, so every algorithm keeps only its
+// newest result: a request at an older generation of the same graph comes from a reader still on
+// an older snapshot and is solved without replacing it.
+// Concurrent requests for a key that is not cached yet are coalesced (single flight): the first
+// one becomes the leader and computes, the others wait on the same shared future.
+// Thread safe, independent of the graph lock.
+class ResultCache {
+public:
+    typedef std::shared_future<std::shared_ptr<const SolveResult>> SharedResult;
+
+    struct Flight {
+        SharedResult result;    // ready right away on a cache hit
+        bool leader;            // the caller must compute and then call complete() or abandon()
+    };
+
+    // Cached result, the computation already running for the key, or a new one led by the caller
+    Flight join(unsigned long long generation, MSTFactory::MSTType type);
+
+    // Called by the leader: hands the result to every waiter and stores it
+    void complete(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result);
+
+    // Called by the leader when computing failed: the waiters get the exception, nothing is stored
+    void abandon(unsigned long long generation, MSTFactory::MSTType type, std::exception_ptr error);
+
+    // Result of type for exactly this generation, nullptr if there is none
+    std::shared_ptr<const SolveResult> find(unsigned long long generation, MSTFactory::MSTType type);
+
+    // Keep result unless a newer generation is already stored for type
+    void store(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result);
+
+private:
+    struct Entry {
+        unsigned long long generation;
+        std::shared_ptr<const SolveResult> result;
+    };
+    struct InFlight {
+        std::promise<std::shared_ptr<const SolveResult>> promise;
+        SharedResult result;
+    };
+    typedef std::pair<MSTFactory::MSTType, unsigned long long> Key;
+
+    void storeLocked(unsigned long long generation, MSTFactory::MSTType type, std::shared_ptr<const SolveResult> result);
+
+    std::map<MSTFactory::MSTType, Entry> entries;
+    std::map<Key, InFlight> inFlight;
+    std::mutex mtx;
+};
+
+#endif // RESULT_CACHE_HPP
@@ -0,0 +1,150 @@
+#include "ServerCommands.hpp"
+#include "MSTFactory.hpp"
+#include "MSTClustering.hpp"
+#include "BatchSolver.hpp"
+#include "Bottleneck.hpp"
+#include "TreePathIndex.hpp"
+#include "ResultCache.hpp"
+#include "CommandParser.hpp"
+#include <memory>
+#include <random>
+
+// Result of type for graph through the single-flight cache of the graph: only the leader of a
+// flight solves, concurrent requests for the same generation wait for its result
+static std::shared_ptr<const SolveResult> sharedSolve(const Graph& graph, ResultCache& results, MSTFactory::MSTType type) {
+    unsigned long long generation = graph.getGeneration();
+    ResultCache::Flight flight = results.join(generation, type);
+    if (!flight.leader) {
+        return flight.result.get();
+    }
+    try {
+        std::shared_ptr<const SolveResult> result = makeSolveResult(MSTFactory::createSolver(type)->solve(graph), type);
+        results.complete(generation, type, result);
+        return result;
+    } catch (...) {
+        results.abandon(generation, type, std::current_exception());
+        throw;
+    }
+}
+
+std::string mstResponse(const Graph& graph, ResultCache& results, MSTFactory::MSTType type) {
+    return sharedSolve(graph, results, type)->response;
+}
+
+std::string clusterResponse(const Graph& graph, GraphCaches& caches, int k) {
+    std::shared_ptr<const Dendrogram> dendrogram = caches.dendrogram(graph);
+    return "Single-linkage clustering (k=" + std::to_string(k) + "):\n" + Dendrogram::printClusters(dendrogram->clustersK(k));
+}
+
+std::string thresholdResponse(const Graph& graph, GraphCaches& caches, int threshold) {
+    std::shared_ptr<const Dendrogram> dendrogram = caches.dendrogram(graph);
+    return "Single-linkage clustering (threshold=" + std::to_string(threshold) + "):\n" + Dendrogram::printClusters(dendrogram->clustersAtThreshold(threshold));
+}
+
+std::string bottleneckResponse(const Graph& graph) {
+    std::vector<Edge> tree = bottleneckSpanningTree(graph);
+    if (tree.empty() && graph.getNumVertices() > 1) {
+        return "Bottleneck spanning tree: graph is not connected\n";
+    }
+    std::string response = "Bottleneck Spanning Tree:\n";
+    for (const Edge& edge : tree) {
+        response += std::to_string(edge.u) + " <-> " + std::to_string(edge.v) + " (" + std::to_string(edge.weight) + ")\n";
+    }
+    response += "Bottleneck weight: " + std::to_string(bottleneckWeight(tree)) + "\n";
+    return response;
+}
+
+std::string minimaxResponse(const Graph& graph, GraphCaches& caches, const std::vector<std::pair<int, int>>& pairs) {
+    std::shared_ptr<const MinimaxIndex> index = caches.minimaxIndex(graph);
+    std::string response = "Minimax path weights:\n";
+    for (const std::pair<int, int>& pair : pairs) {
+        int weight;
+        response += std::to_string(pair.first) + " " + std::to_string(pair.second) + ": ";
+        response += index->query(pair.first, pair.second, weight) ? std::to_string(weight) : "not connected";
+        response += "\n";
+    }
+    return response;
+}
+
+std::string pathResponse(const Graph& graph, GraphCaches& caches, const std::vector<std::pair<int, int>>& pairs) {
+    std::shared_ptr<const TreePathIndex> index = caches.pathIndex(graph);
+    std::string response = "MST paths:\n";
+    for (const std::pair<int, int>& pair : pairs) {
+        long long distance;
+        int heaviest;
+        response += std::to_string(pair.first) + " " + std::to_string(pair.second) + ": ";
+        if (index->distance(pair.first, pair.second, distance) && index->pathMax(pair.first, pair.second, heaviest)) {
+            response += "distance " + std::to_string(distance) + ", max edge " + std::to_string(heaviest) + "\n";
+        } else {
+            response += "not connected\n";
+        }
+    }
+    return response;
+}
+
+std::string sampleResponse(const GraphCSR& snapshot, int numSources) {
+    DistanceSample sample;
+    if (!sampleDistances(snapshot, numSources, std::random_device()(), sample)) {
+        return "Distance sample: needs at least 2 vertices, 1 source and non-negative weights\n";
+    }
+    return printDistanceSample(sample);
+}
+
+bool readPairs(SocketIntReader& reader, int numPairs, std::vector<std::pair<int, int>>& pairs) {
+    pairs.reserve(numPairs);
+    for (int i = 0; i < numPairs; ++i) {
+        int u, v;
+        if (!reader.next(u) || !reader.next(v)) {
+            return false;
+        }
+        pairs.push_back({u, v});
+    }
+    return true;
+}
+
+std::string batchResponse(SocketIntReader& reader, int numGraphs) {
+    GraphBatch batch;
+    size_t batchBytes = 0;
+    for (int g = 0; g < numGraphs; ++g) {
+        int vertices, edges;
+        if (!reader.next(vertices) || !reader.next(edges) || vertices < 0 || edges < 0) {
+            return "Error: Invalid batch format in graph " + std::to_string(g) + "\n";
+        }
+        // refused before anything of the graph is allocated
+        if (vertices > MAX_BATCH_GRAPH_VERTICES) {
+            return "Error: Graph " + std::to_string(g) + " of the batch has more than " + std::to_string(MAX_BATCH_GRAPH_VERTICES) + " vertices\n";
+        }
+        batchBytes += GraphBatch::memoryFor(vertices, edges);
+        if (batchBytes > MAX_BATCH_BYTES) {
+            return "Error: Batch exceeds " + std::to_string(MAX_BATCH_BYTES >> 20) + " MB at graph " + std::to_string(g) + "\n";
+        }
+        batch.beginGraph(vertices);
+        for (int e = 0; e < edges; ++e) {
+            int u, v, weight;
+            if (!reader.next(u) || !reader.next(v) || !reader.next(weight)) {
+                return "Error: Invalid batch format in graph " + std::to_string(g) + "\n";
+            }
+            batch.addEdge(u, v, weight);
+        }
+    }
+    return printBatchResult(solveBatch(batch));
+}
+
+// ---------------------------- SocketIntReader ----------------------------
+SocketIntReader::SocketIntReader(std::string_view text) : text(text), pos(0) {}
+
+bool SocketIntReader::next(int& value) {
+    while (pos < text.size() && isSpace(text[pos])) {
+        pos++;
+    }
+    if (pos == text.size()) {
+        return false;
+    }
+    size_t end = pos;
+    while (end < text.size() && !isSpace(text[end])) {
+        end++;
+    }
+    std::string_view token = text.substr(pos, end - pos);
+    pos = end;
+    return parseInt(token, value);
+}
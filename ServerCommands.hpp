@@ -0,0 +1,66 @@
+#ifndef SERVER_COMMANDS_HPP
+#define SERVER_COMMANDS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include "Graph.hpp"
+#include "MSTFactory.hpp"
+#include "DistanceSampling.hpp"
+#include "GraphCaches.hpp"
+#include "ResultCache.hpp"
+
+// Query commands of every server, run by ClientSession (ServerSession.hpp) for the reactor, the
+// Leader-Follower pool and the thread pool server, and by the solve jobs it submits.
+// graph is a snapshot of one graph of the registry (see GraphRegistry.hpp) and is only read, so
+// the commands run without any lock and in parallel. The query structures built from a snapshot
+// are kept in the caches of its graph (GraphCaches.hpp), shared by every reader of that generation.
+
+// "Boruvka" / "Prim" / "Kruskal" - MST and metrics, cached in results (those of the graph) per
+// generation and algorithm. Concurrent requests for the same generation and algorithm share one solve
+std::string mstResponse(const Graph& graph, ResultCache& results, MSTFactory::MSTType type);
+
+// "Clusters k" - single-linkage clustering of the graph into k clusters
+std::string clusterResponse(const Graph& graph, GraphCaches& caches, int k);
+
+// "Cut t" - single-linkage clusters after removing all MST edges heavier than t
+std::string thresholdResponse(const Graph& graph, GraphCaches& caches, int threshold);
+
+// "Bottleneck" - minimum bottleneck spanning tree (Camerini) and its bottleneck weight
+std::string bottleneckResponse(const Graph& graph);
+
+// "Minimax n u1 v1 ... un vn" - minimax path weight of every pair, from the cached index
+std::string minimaxResponse(const Graph& graph, GraphCaches& caches, const std::vector<std::pair<int, int>>& pairs);
+
+// "Path n u1 v1 ... un vn" - tree distance and heaviest edge between every pair in the MST (the
+// minimum spanning forest), from the cached path index
+std::string pathResponse(const Graph& graph, GraphCaches& caches, const std::vector<std::pair<int, int>>& pairs);
+
+// "Sample k" - shortest-path distance statistics of the graph estimated from k random sources.
+// Runs on a CSR copy of the graph, laid out for the searches
+std::string sampleResponse(const GraphCSR& snapshot, int numSources);
+
+// "Batch n" followed by n graphs "V E u v w ..." - solves all of them at once, one response.
+// The graphs are read through reader from the rest of the command
+class SocketIntReader;
+std::string batchResponse(SocketIntReader& reader, int numGraphs);
+
+// Read numPairs vertex pairs, false on a malformed or truncated list
+bool readPairs(SocketIntReader& reader, int numPairs, std::vector<std::pair<int, int>>& pairs);
+
+// Reads the whitespace separated integers that follow a command, in place from a view of the rest
+// of the command. The CommandFramer delivers a command only once all of it arrived, so the text
+// is complete and never read from the socket
+class SocketIntReader {
+public:
+    explicit SocketIntReader(std::string_view text);
+    // false at the end of the text or on something that is not an integer
+    bool next(int& value);
+
+private:
+    std::string_view text;
+    size_t pos;
+};
+
+#endif // SERVER_COMMANDS_HPP
@@ -0,0 +1,752 @@
+#include "ServerSession.hpp"
+#include "ServerCommands.hpp"
+#include "MSTFactory.hpp"
+#include "SolvePipeline.hpp"
+#include "WireProtocol.hpp"
+#include "JobStore.hpp"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+// A bulk Newgraph may not carry more edges than a binary Newgraph frame holds
+#define MAX_BULK_EDGES static_cast<int>(MAX_FRAME_SIZE / EDGE_RECORD_SIZE)
+// Records reserved up front for a bulk Newgraph, the rest grows as the edges arrive
+#define BULK_RESERVE_EDGES (1 << 16)
+
+// The arguments of "Newgraph [name] V E [mode]" after the command name. The name is optional: a
+// graph name never starts like a number, so the first token is the vertex count if it is one
+static bool parseNewgraph(Tokenizer& tokens, std::string_view& name, int& vertices, int& edges, std::string_view& mode) {
+    std::string_view token;
+    if (!tokens.next(token)) {
+        return false;
+    }
+    name = std::string_view();
+    if (!parseInt(token, vertices)) {
+        name = token;
+        if (!tokens.nextInt(vertices)) {
+            return false;
+        }
+    }
+    if (!tokens.nextInt(edges)) {
+        return false;
+    }
+    mode = std::string_view();
+    tokens.next(mode);
+    return true;
+}
+
+// The size of the graph once it has the given number of edges more
+static size_t withEdges(const Graph& graph, size_t edges) {
+    return graph.memoryUsage() + Graph::memoryFor(0, edges) - Graph::memoryFor(0, 0);
+}
+
+// ---------------------------- CommandFramer ----------------------------
+void CommandFramer::feed(const char* data, size_t size) {
+    size_t skipped = std::min(size, skipRemaining);
+    skipRemaining -= skipped;
+    // the commands taken so far are dropped once per segment, not once per command
+    buffer.erase(0, head);
+    head = 0;
+    buffer.append(data + skipped, size - skipped);
+}
+
+bool CommandFramer::isBinary() const {
+    return protocol == BINARY;
+}
+
+size_t CommandFramer::buffered() const {
+    return buffer.size() - head;
+}
+
+bool CommandFramer::nextFrame(std::string& frame) {
+    if (buffer.size() - head < 4) {
+        return false;
+    }
+    uint32_t length = readU32(buffer.data() + head);
+    if (length > MAX_FRAME_SIZE) {
+        // never buffered: the frame is dropped as it arrives and answered with an error
+        size_t available = std::min<size_t>(buffer.size() - head - 4, length);
+        skipRemaining = length - available;
+        head += 4 + available;
+        frame.assign(1, static_cast<char>(FRAME_TOO_LARGE));
+        return true;
+    }
+    if (buffer.size() - head - 4 < length) {
+        return false;
+    }
+    frame.assign(buffer, head + 4, length);
+    head += 4 + length;
+    return true;
+}
+
+// Next whitespace separated token at or after pos. A token that touches the end of the buffer
+// may still continue, unless the data is complete for now
+bool CommandFramer::nextToken(size_t& pos, size_t& begin, size_t& end, bool endOfData) const {
+    while (pos < buffer.size() && isSpace(buffer[pos])) {
+        pos++;
+    }
+    if (pos == buffer.size()) {
+        return false;
+    }
+    begin = pos;
+    while (pos < buffer.size() && !isSpace(buffer[pos])) {
+        pos++;
+    }
+    if (pos == buffer.size() && !endOfData) {
+        return false;
+    }
+    end = pos;
+    return true;
+}
+
+bool CommandFramer::nextInt(size_t& pos, int& value, bool& malformed, bool endOfData) const {
+    size_t begin, end;
+    if (!nextToken(pos, begin, end, endOfData)) {
+        return false;
+    }
+    malformed = !parseInt(std::string_view(buffer).substr(begin, end - begin), value);
+    return true;
+}
+
+// End of a list command whose name ends at pos, npos while more numbers are needed. A malformed
+// list ends with its line, the command then fails when it is executed
+size_t CommandFramer::listCommandEnd(CommandId command, size_t pos, bool endOfData) const {
+    auto lineEnd = [&](size_t from) {
+        size_t newline = buffer.find('\n', from);
+        return newline != std::string::npos ? newline : endOfData ? buffer.size() : std::string::npos;
+    };
+    int count;
+    bool malformed;
+    if (!nextInt(pos, count, malformed, endOfData)) {
+        return std::string::npos;
+    }
+    if (malformed || count < 0) {
+        return lineEnd(pos);
+    }
+
+    // numbers per item: 2 per pair, 2 + 3 E per graph of a batch
+    for (int item = 0; item < count; ++item) {
+        long needed = 2;
+        if (command == CMD_BATCH) {
+            int vertices, edges;
+            if (!nextInt(pos, vertices, malformed, endOfData) || (!malformed && !nextInt(pos, edges, malformed, endOfData))) {
+                return std::string::npos;
+            }
+            if (malformed || vertices < 0 || edges < 0) {
+                return lineEnd(pos);
+            }
+            needed = 3L * edges;
+        }
+        for (long i = 0; i < needed; ++i) {
+            int value;
+            if (!nextInt(pos, value, malformed, endOfData)) {
+                return std::string::npos;
+            }
+            if (malformed) {
+                return lineEnd(pos);
+            }
+        }
+    }
+    return pos;
+}
+
+bool CommandFramer::nextCommand(std::string& command, bool endOfData) {
+    if (protocol == UNDECIDED) {
+        // no text command starts like the magic bytes, so a prefix of them is worth waiting for
+        size_t compared = std::min(buffer.size() - head, PROTOCOL_MAGIC_SIZE);
+        bool magic = buffer.compare(head, compared, PROTOCOL_MAGIC, compared) == 0;
+        if (magic && buffer.size() - head <= PROTOCOL_MAGIC_SIZE) {
+            return false;
+        }
+        if (magic) {
+            protocol = BINARY;
+            command.assign(1, static_cast<char>(FRAME_HELLO));
+            command.push_back(buffer[head + PROTOCOL_MAGIC_SIZE]);
+            head += PROTOCOL_MAGIC_SIZE + 1;
+            return true;
+        }
+        protocol = TEXT;
+    }
+    if (protocol == BINARY) {
+        return nextFrame(command);
+    }
+    if (inBulk) {
+        return nextBulkGraph(command, endOfData);
+    }
+
+    while (head < buffer.size() && isSpace(buffer[head])) {
+        head++;
+    }
+    size_t pos = head, begin, end;
+    if (!nextToken(pos, begin, end, endOfData)) {
+        return false;
+    }
+    CommandId id = commandId(std::string_view(buffer).substr(begin, end - begin));
+
+    size_t commandEnd;
+    if (id == CMD_BATCH || id == CMD_MINIMAX || id == CMD_PATH) {
+        commandEnd = listCommandEnd(id, pos, endOfData);
+    } else {
+        size_t newline = buffer.find('\n', pos);
+        commandEnd = newline != std::string::npos ? newline : endOfData ? buffer.size() : std::string::npos;
+    }
+    if (commandEnd == std::string::npos) {
+        return false;
+    }
+    // assign reuses the capacity of command, the caller's string is not reallocated every time
+    command.assign(buffer, head, commandEnd - head);
+    head = commandEnd;
+
+    // "Newgraph [name] V E bulk": the edges that follow are parsed as they arrive
+    if (id == CMD_NEWGRAPH) {
+        Tokenizer header(command);
+        std::string_view keyword, name, mode;
+        int vertices, edges;
+        if (header.next(keyword) && parseNewgraph(header, name, vertices, edges, mode) && mode == "bulk"
+            && vertices >= 0 && edges >= 0) {
+            bulkValuesLeft = 3L * edges;
+            inBulk = true;
+            if (edges > MAX_BULK_EDGES) {
+                // the header alone goes out now and is refused, its numbers are dropped as they arrive
+                bulkSkipping = true;
+                return true;
+            }
+            bulkCommand = command + "\n";
+            bulkCommand.reserve(bulkCommand.size() + std::min(edges, BULK_RESERVE_EDGES) * EDGE_RECORD_SIZE);
+            return nextBulkGraph(command, endOfData);
+        }
+    }
+    return true;
+}
+
+bool CommandFramer::nextBulkGraph(std::string& command, bool endOfData) {
+    if (!parseBulkEdges(endOfData)) {
+        return false;
+    }
+    if (bulkSkipping) {
+        bulkSkipping = false;
+        inBulk = false;
+        return nextCommand(command, endOfData);
+    }
+    command.swap(bulkCommand);
+    bulkCommand.clear();
+    bulkCommand.shrink_to_fit();
+    inBulk = false;
+    return true;
+}
+
+// Parse the numbers of a bulk Newgraph straight into edge records, each byte once. Only the very
+// last number may end with the data, any other one touching the end continues in the next segment
+bool CommandFramer::parseBulkEdges(bool endOfData) {
+    const size_t size = buffer.size();
+    size_t pos = head;
+    bool malformed = false;
+    while (bulkValuesLeft > 0) {
+        while (pos < size && isSpace(buffer[pos])) {
+            pos++;
+        }
+        size_t begin = pos;
+        bool negative = pos < size && buffer[pos] == '-';
+        pos += negative;
+        size_t digits = pos;
+        long long value = 0;
+        while (pos < size && buffer[pos] >= '0' && buffer[pos] <= '9' && value <= INT_MAX) {
+            value = value * 10 + (buffer[pos] - '0');
+            pos++;
+        }
+        if (begin == size || (pos == size && (bulkValuesLeft > 1 || !endOfData))) {
+            pos = begin;
+            break;
+        }
+        if (pos == digits || (pos < size && !isSpace(buffer[pos])) || value > INT_MAX) {
+            malformed = true;
+            break;
+        }
+        if (!bulkSkipping) {
+            putU32(bulkCommand, static_cast<uint32_t>(negative ? -value : value));
+        }
+        bulkValuesLeft--;
+    }
+    if (malformed) {
+        // the list ends with the line of the bad number, the session rejects the short list
+        size_t newline = buffer.find('\n', pos);
+        pos = newline == std::string::npos ? size : newline;
+        bulkValuesLeft = 0;
+    }
+    head = pos;
+    return bulkValuesLeft == 0;
+}
+
+// ---------------------------- ClientSession ----------------------------
+ClientSession::ClientSession(GraphRegistry& graphs, const SolvePipeline* pipeline)
+    : graphs(graphs), pipeline(pipeline), currentName(GraphRegistry::DEFAULT_GRAPH), expectedEdges(0) {}
+
+bool ClientSession::expectsEdges() const {
+    return expectedEdges > 0;
+}
+
+bool ClientSession::mutates(std::string_view command, bool binary) const {
+    if (binary) {
+        if (command.empty()) {
+            return false;
+        }
+        uint8_t type = static_cast<uint8_t>(command[0]);
+        return type == FRAME_TEXT ? mutates(command.substr(1), false) : type != FRAME_TOO_LARGE;
+    }
+    if (expectedEdges > 0) {
+        return true;
+    }
+    Tokenizer tokens(command);
+    std::string_view name;
+    tokens.next(name);
+    CommandId id = commandId(name);
+    return id == CMD_NEWGRAPH || id == CMD_NEWEDGE || id == CMD_REMOVEEDGE || id == CMD_USE || id == CMD_DROPGRAPH;
+}
+
+std::shared_ptr<NamedGraph> ClientSession::currentGraph() const {
+    std::shared_ptr<NamedGraph> graph = std::atomic_load(&current);
+    if (!graph || graph->dropped) {
+        // dropped by some client: a graph created under the same name since takes its place
+        graph = graphs.find(currentName);
+        std::atomic_store(&current, graph);
+    }
+    return graph;
+}
+
+GraphSnapshot ClientSession::snapshot() const {
+    std::shared_ptr<NamedGraph> graph = currentGraph();
+    return graph ? graph->store.snapshot() : nullptr;
+}
+
+std::string ClientSession::noGraph() const {
+    std::cout << "Error: No graph named " << currentName << "\n";
+    return "Error: No graph named " + currentName + "\n";
+}
+
+// Reply for a change GraphRegistry::update did not run
+std::string ClientSession::refused(const NamedGraph& graph) const {
+    std::string reply = graph.dropped ? "Error: No graph named " + graph.name + "\n" : "Error: Graph memory quota exceeded\n";
+    std::cout << reply;
+    return reply;
+}
+
+std::string ClientSession::addExpectedEdge(std::string_view command) {
+    Tokenizer tokens(command);
+    int u, v, weight;
+    if (!tokens.nextInt(u) || !tokens.nextInt(v) || !tokens.nextInt(weight)) {
+        std::cout << "Error: Invalid edge format\n";
+        return "";
+    }
+    std::shared_ptr<NamedGraph> graph = currentGraph();
+    if (!graph) {
+        expectedEdges = 0;
+        return noGraph();
+    }
+    bool inRange = false;
+    bool fits = graphs.update(*graph, [](const Graph& contents) { return withEdges(contents, 1); }, [&](Graph& contents) {
+        inRange = u >= 0 && v >= 0 && u < contents.getNumVertices() && v < contents.getNumVertices();
+        if (inRange) {
+            contents.addEdge(u, v, weight);
+        }
+    });
+    if (!fits) {
+        expectedEdges = 0;
+        return refused(*graph);
+    }
+    if (!inRange) {
+        std::cout << "Error: Vertex index out of bounds\n";
+        return "";
+    }
+    expectedEdges--;
+    std::cout << "Added edge " << u << "<->" << v << " [" << weight << "]. " << expectedEdges << " edges remaining.\n";
+    return "Edge added. " + std::to_string(expectedEdges) + " edges remaining.\n";
+}
+
+std::string ClientSession::newGraph(Tokenizer& tokens, std::string_view command) {
+    std::string_view name, mode;
+    int vertices, edges;
+    if (!parseNewgraph(tokens, name, vertices, edges, mode) || vertices < 0) {
+        std::cout << "Error: Invalid graph command format\n";
+        return "";
+    }
+    bool bulk = mode == "bulk";
+    if (bulk && edges > MAX_BULK_EDGES) {
+        std::cout << "Error: Bulk graph too large\n";
+        return "Error: Bulk graph too large, at most " + std::to_string(MAX_BULK_EDGES) + " edges\n";
+    }
+    // the framer has already turned the edges of a bulk graph into records after the header line
+    size_t records = command.find('\n');
+    if (bulk && (edges < 0 || records == std::string_view::npos
+                 || command.size() - records - 1 != static_cast<size_t>(edges) * EDGE_RECORD_SIZE)) {
+        std::cout << "Error: Invalid bulk edge list\n";
+        return "Error: Invalid bulk edge list\n";
+    }
+
+    std::shared_ptr<NamedGraph> graph = name.empty() ? currentGraph() : graphs.open(name);
+    if (!graph) {
+        std::string reply = name.empty() ? "Error: No graph named " + currentName + "\n"
+                          : GraphRegistry::validName(name) ? "Error: Too many graphs\n" : "Error: Invalid graph name\n";
+        std::cout << reply;
+        return reply;
+    }
+    // the edges of a plain Newgraph are charged one by one as they arrive
+    size_t planned = bulk ? edges : 0;
+    uint32_t added = 0;
+    bool fits = graphs.update(*graph, [&](const Graph&) { return Graph::memoryFor(vertices, planned); }, [&](Graph& contents) {
+        contents.resetGraph(vertices);
+        if (bulk) {
+            added = addEdgeRecords(contents, command.data() + records + 1, edges);
+        }
+    });
+    if (!fits) {
+        return refused(*graph);
+    }
+    if (!name.empty()) {
+        currentName = graph->name;
+        std::atomic_store(&current, graph);
+    }
+    if (bulk) {
+        expectedEdges = 0;
+        std::cout << "Graph created with " << vertices << " vertices and " << added << " edges.\n";
+        return "Graph created with " + std::to_string(vertices) + " vertices and " + std::to_string(added) + " edges.\n";
+    }
+    expectedEdges = edges;
+    std::cout << "Graph created with " << vertices << " vertices. Waiting for " << edges << " edges.\n";
+    return "Graph created. Send " + std::to_string(edges) + " edges (u v weight).\n";
+}
+
+std::string ClientSession::useGraph(std::string_view name) {
+    std::shared_ptr<NamedGraph> graph = graphs.find(name);
+    if (!graph) {
+        std::cout << "Error: No graph named " << name << "\n";
+        return "Error: No graph named " + std::string(name) + "\n";
+    }
+    currentName = graph->name;
+    std::atomic_store(&current, graph);
+    std::cout << "Using graph " << name << ".\n";
+    return "Using graph " + std::string(name) + ".\n";
+}
+
+// A background job of the graph has finished with its snapshot, it no longer counts against
+// MAX_GRAPH_JOBS. The job does not keep the graph alive: a dropped graph has nothing to count
+static void jobFinished(const std::weak_ptr<NamedGraph>& owner) {
+    if (std::shared_ptr<NamedGraph> named = owner.lock()) {
+        named->jobs--;
+    }
+}
+
+// Solve the snapshot in the background, the job keeps the version of the graph it was submitted on
+std::string ClientSession::submitJob(std::string_view algorithm, const std::shared_ptr<NamedGraph>& named, GraphSnapshot graph) {
+    MSTFactory::MSTType type;
+    switch (commandId(algorithm)) {
+        case CMD_BORUVKA:
+            type = MSTFactory::BORUVKA;
+            break;
+        case CMD_PRIM:
+            type = MSTFactory::PRIM;
+            break;
+        case CMD_KRUSKAL:
+            type = MSTFactory::PARALLEL_KRUSKAL;
+            break;
+        default:
+            std::cout << "Error: Unknown algorithm " << algorithm << "\n";
+            return "Error: Unknown algorithm " + std::string(algorithm) + "\n";
+    }
+    size_t pending = named->jobs;
+    do {
+        if (pending >= MAX_GRAPH_JOBS) {
+            std::cout << "Error: Too many unfinished jobs on graph " << named->name << "\n";
+            return "Error: Too many unfinished jobs on graph " + named->name + "\n";
+        }
+    } while (!named->jobs.compare_exchange_weak(pending, pending + 1));
+    std::weak_ptr<NamedGraph> owner = named;
+    std::shared_ptr<ResultCache> results = named->results;
+    uint64_t job = sharedJobStore().submit([graph, type, owner, results] {
+        std::string response;
+        try {
+            response = mstResponse(*graph, *results, type);
+        } catch (...) {
+            jobFinished(owner);
+            throw;
+        }
+        jobFinished(owner);
+        return response;
+    });
+    if (job == 0) {
+        jobFinished(owner);
+        std::cout << "Error: Too many unfinished jobs\n";
+        return "Error: Too many unfinished jobs\n";
+    }
+    std::cout << "Job " << job << " submitted.\n";
+    return "Job " + std::to_string(job) + " submitted.\n";
+}
+
+// "Status <id>" / "Result <id>"
+std::string ClientSession::jobResponse(uint64_t job, bool result) const {
+    JobStore::State state;
+    std::string response;
+    if (!sharedJobStore().find(job, state, response)) {
+        std::cout << "Error: No job " << job << "\n";
+        return "Error: No job " + std::to_string(job) + "\n";
+    }
+    if (!result) {
+        return "Job " + std::to_string(job) + ": " + JobStore::stateName(state) + "\n";
+    }
+    if (state == JobStore::DONE) {
+        return response;
+    }
+    if (state == JobStore::FAILED) {
+        return "Error: Job " + std::to_string(job) + " failed\n";
+    }
+    return "Job " + std::to_string(job) + " is not done yet (" + JobStore::stateName(state) + ").\n";
+}
+
+std::string ClientSession::execute(std::string_view command) {
+    // the lines after a Newgraph are its edges
+    if (expectedEdges > 0) {
+        return addExpectedEdge(command);
+    }
+
+    Tokenizer tokens(command);
+    std::string_view name;
+    tokens.next(name);
+    CommandId id = commandId(name);
+
+    // every other command works on the current graph, which another client may have dropped
+    GraphSnapshot graph;
+    std::shared_ptr<NamedGraph> named;
+    if (id != CMD_UNKNOWN && id != CMD_NEWGRAPH && id != CMD_BATCH && id != CMD_STATS && id != CMD_USE && id != CMD_DROPGRAPH
+        && id != CMD_STATUS && id != CMD_RESULT) {
+        named = currentGraph();
+        if (!named) {
+            return noGraph();
+        }
+        if (id != CMD_NEWEDGE && id != CMD_REMOVEEDGE) {
+            graph = named->store.snapshot();
+        }
+    }
+
+    switch (id) {
+        case CMD_NEWGRAPH:
+            return newGraph(tokens, command);
+        case CMD_NEWEDGE: {
+            int u, v, weight;
+            if (tokens.nextInt(u) && tokens.nextInt(v) && tokens.nextInt(weight)) {
+                bool inRange = false;
+                bool fits = graphs.update(*named, [](const Graph& contents) { return withEdges(contents, 1); }, [&](Graph& contents) {
+                    inRange = u >= 0 && v >= 0 && u < contents.getNumVertices() && v < contents.getNumVertices();
+                    if (inRange) {
+                        contents.addEdge(u, v, weight);
+                    }
+                });
+                if (!fits) {
+                    return refused(*named);
+                }
+                if (inRange) {
+                    std::cout << "Added edge " << u << "<->" << v << " [" << weight << "].\n";
+                } else {
+                    std::cout << "Error: Vertex index out of bounds\n";
+                }
+            } else {
+                std::cout << "Error: Invalid edge command format\n";
+            }
+            break;
+        }
+        case CMD_REMOVEEDGE: {
+            int u, v;
+            if (tokens.nextInt(u) && tokens.nextInt(v)) {
+                bool inRange = false;
+                bool fits = graphs.update(*named, [](const Graph& contents) { return contents.memoryUsage(); }, [&](Graph& contents) {
+                    inRange = u >= 0 && v >= 0 && u < contents.getNumVertices() && v < contents.getNumVertices();
+                    if (inRange) {
+                        contents.removeEdge(u, v);
+                    }
+                });
+                if (!fits) {
+                    return refused(*named);
+                }
+                if (inRange) {
+                    std::cout << "Removed edge from " << u << " to " << v << ".\n";
+                } else {
+                    std::cout << "Error: Vertex index out of bounds\n";
+                }
+            } else {
+                std::cout << "Error: Invalid edge command format\n";
+            }
+            break;
+        }
+        case CMD_BORUVKA:
+            return mstResponse(*graph, *named->results, MSTFactory::BORUVKA);
+        case CMD_PRIM:
+            return mstResponse(*graph, *named->results, MSTFactory::PRIM);
+        case CMD_KRUSKAL:
+            return mstResponse(*graph, *named->results, MSTFactory::PARALLEL_KRUSKAL);
+        case CMD_BATCH: {
+            int numGraphs;
+            if (tokens.nextInt(numGraphs) && numGraphs >= 0) {
+                // the framer delivered the whole batch, the batch does not touch the shared graphs
+                SocketIntReader reader(tokens.rest());
+                return batchResponse(reader, numGraphs);
+            }
+            std::cout << "Error: Invalid batch command format\n";
+            break;
+        }
+        case CMD_BOTTLENECK:
+            return bottleneckResponse(*graph);
+        case CMD_MINIMAX:
+        case CMD_PATH: {
+            int numPairs;
+            if (tokens.nextInt(numPairs) && numPairs >= 0) {
+                SocketIntReader reader(tokens.rest());
+                std::vector<std::pair<int, int>> pairs;
+                if (readPairs(reader, numPairs, pairs)) {
+                    return id == CMD_MINIMAX ? minimaxResponse(*graph, named->caches, pairs) : pathResponse(*graph, named->caches, pairs);
+                }
+                std::cout << "Error: Invalid " << name << " pair list\n";
+            } else {
+                std::cout << "Error: Invalid " << name << " command format\n";
+            }
+            break;
+        }
+        case CMD_CLUSTERS: {
+            int k;
+            if (tokens.nextInt(k)) {
+                return clusterResponse(*graph, named->caches, k);
+            }
+            std::cout << "Error: Invalid clusters command format\n";
+            break;
+        }
+        case CMD_CUT: {
+            int threshold;
+            if (tokens.nextInt(threshold)) {
+                return thresholdResponse(*graph, named->caches, threshold);
+            }
+            std::cout << "Error: Invalid cut command format\n";
+            break;
+        }
+        case CMD_SAMPLE: {
+            int numSources;
+            if (tokens.nextInt(numSources) && numSources > 0) {
+                return sampleResponse(GraphCSR(*graph), numSources);
+            }
+            std::cout << "Error: Invalid sample command format\n";
+            break;
+        }
+        case CMD_STATS:
+            return pipeline ? pipeline->statsResponse() : "No solve pipeline in this server.\n";
+        case CMD_USE: {
+            std::string_view graphName;
+            if (tokens.next(graphName)) {
+                return useGraph(graphName);
+            }
+            std::cout << "Error: Invalid use command format\n";
+            break;
+        }
+        case CMD_DROPGRAPH: {
+            std::string_view graphName;
+            if (!tokens.next(graphName)) {
+                std::cout << "Error: Invalid dropgraph command format\n";
+                break;
+            }
+            if (graphName == GraphRegistry::DEFAULT_GRAPH) {
+                std::cout << "Error: The default graph cannot be dropped\n";
+                return "Error: The default graph cannot be dropped\n";
+            }
+            if (!graphs.drop(graphName)) {
+                std::cout << "Error: No graph named " << graphName << "\n";
+                return "Error: No graph named " + std::string(graphName) + "\n";
+            }
+            std::cout << "Dropped graph " << graphName << ".\n";
+            return "Dropped graph " + std::string(graphName) + ".\n";
+        }
+        case CMD_SUBMIT: {
+            std::string_view algorithm;
+            if (!tokens.next(algorithm)) {
+                std::cout << "Error: Invalid submit command format\n";
+                break;
+            }
+            return submitJob(algorithm, named, graph);
+        }
+        case CMD_STATUS:
+        case CMD_RESULT: {
+            int job;
+            if (tokens.nextInt(job) && job > 0) {
+                return jobResponse(job, id == CMD_RESULT);
+            }
+            std::cout << "Error: Invalid " << name << " command format\n";
+            break;
+        }
+        case CMD_UNKNOWN:
+            std::cout << "Unknown command.\n";
+            break;
+    }
+    return "";
+}
+
+std::string ClientSession::executeFrame(const std::string& frame) {
+    if (frame.empty()) {
+        return encodeFrame(REPLY_ERROR, "Error: Empty frame\n");
+    }
+    const char* payload = frame.data() + 1;
+    size_t size = frame.size() - 1;
+
+    switch (static_cast<uint8_t>(frame[0])) {
+        case FRAME_HELLO: {
+            uint8_t version = static_cast<uint8_t>(frame[1]);
+            if (version == 0) {
+                return encodeFrame(REPLY_ERROR, "Error: Unsupported protocol version\n");
+            }
+            std::cout << "Client speaks binary protocol version " << int(version) << ".\n";
+            return encodeFrame(REPLY_OK, std::string(1, static_cast<char>(std::min(version, PROTOCOL_VERSION))));
+        }
+        case FRAME_TEXT:
+            return encodeFrame(REPLY_OK, execute(std::string_view(payload, size)));
+        case FRAME_NEW_GRAPH: {
+            if (size < 8 || (size - 8) % EDGE_RECORD_SIZE != 0 || readU32(payload + 4) != (size - 8) / EDGE_RECORD_SIZE
+                || readI32(payload) < 0) {
+                return encodeFrame(REPLY_ERROR, "Error: Invalid graph frame\n");
+            }
+            std::shared_ptr<NamedGraph> graph = currentGraph();
+            if (!graph) {
+                return encodeFrame(REPLY_ERROR, noGraph());
+            }
+            int vertices = readI32(payload);
+            uint32_t edges = readU32(payload + 4);
+            uint32_t added;
+            bool fits = graphs.update(*graph, [&](const Graph&) { return Graph::memoryFor(vertices, edges); }, [&](Graph& contents) {
+                contents.resetGraph(vertices);
+                added = addEdgeRecords(contents, payload + 8, edges);
+            });
+            if (!fits) {
+                return encodeFrame(REPLY_ERROR, refused(*graph));
+            }
+            expectedEdges = 0;
+            std::cout << "Graph created with " << vertices << " vertices and " << added << " edges.\n";
+            return encodeFrame(REPLY_OK, "Graph created with " + std::to_string(vertices) + " vertices and " + std::to_string(added) + " edges.\n");
+        }
+        case FRAME_ADD_EDGES: {
+            if (size < 4 || (size - 4) % EDGE_RECORD_SIZE != 0 || readU32(payload) != (size - 4) / EDGE_RECORD_SIZE) {
+                return encodeFrame(REPLY_ERROR, "Error: Invalid edge frame\n");
+            }
+            std::shared_ptr<NamedGraph> graph = currentGraph();
+            if (!graph) {
+                return encodeFrame(REPLY_ERROR, noGraph());
+            }
+            uint32_t count = readU32(payload);
+            uint32_t added;
+            bool fits = graphs.update(*graph, [&](const Graph& contents) { return withEdges(contents, count); }, [&](Graph& contents) {
+                added = addEdgeRecords(contents, payload + 4, count);
+            });
+            if (!fits) {
+                return encodeFrame(REPLY_ERROR, refused(*graph));
+            }
+            std::cout << "Added " << added << " edges.\n";
+            return encodeFrame(REPLY_OK, "Added " + std::to_string(added) + " edges.\n");
+        }
+        case FRAME_TOO_LARGE:
+            return encodeFrame(REPLY_ERROR, "Error: Frame too large\n");
+        default:
+            return encodeFrame(REPLY_ERROR, "Error: Unknown frame type\n");
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef SERVER_SESSION_HPP
+#define SERVER_SESSION_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include "Graph.hpp"
+#include "GraphRegistry.hpp"
+#include "CommandParser.hpp"
+
+class SolvePipeline;
+
+// Splits the byte stream of a connection into commands, independent of how the bytes arrive.
+// A command is one line, except the list commands (Batch, Minimax, Path) that run over as many
+// lines as their counts need. A command ends at its newline (a list at the whitespace after its
+// last number), however the bytes were split into segments: a partial one stays buffered until
+// the rest arrives. Only at the real end of the stream (endOfData, the client hung up) does a
+// plain command without a newline, or a number at the very end of a list, count as complete.
+//
+// "Newgraph [name] V E bulk" is followed by all 3E numbers of the edges, across any lines and segments.
+// They are parsed as they arrive, and the command comes out as its header line followed by the
+// edges already as edge records (WireProtocol.hpp), so the text is never buffered whole. A header
+// with more edges than a binary frame holds comes out alone, right away, and its numbers are
+// dropped as they arrive.
+//
+// A connection that starts with the binary protocol's magic bytes (see WireProtocol.hpp) is split
+// into frames instead: the first command is a FRAME_HELLO holding the client's version, then every
+// command is one frame without its length prefix (type byte and payload).
+class CommandFramer {
+public:
+    void feed(const char* data, size_t size);
+
+    // Take the next complete command out of the buffer, false if there is none yet
+    bool nextCommand(std::string& command, bool endOfData);
+
+    // The connection speaks the binary protocol, pass the commands to ClientSession::executeFrame
+    bool isBinary() const;
+
+    size_t buffered() const;
+
+private:
+    enum Protocol { UNDECIDED, TEXT, BINARY };
+
+    bool nextFrame(std::string& frame);
+    bool nextBulkGraph(std::string& command, bool endOfData);
+    bool parseBulkEdges(bool endOfData);
+    bool nextToken(size_t& pos, size_t& begin, size_t& end, bool endOfData) const;
+    bool nextInt(size_t& pos, int& value, bool& malformed, bool endOfData) const;
+    size_t listCommandEnd(CommandId command, size_t pos, bool endOfData) const;
+
+    std::string buffer;
+    size_t head = 0;                // start of the data not taken as a command yet
+    Protocol protocol = UNDECIDED;
+    size_t skipRemaining = 0;       // bytes of an oversized frame still to be dropped
+    bool inBulk = false;            // inside the edges of a bulk Newgraph
+    std::string bulkCommand;        // its header line and the records parsed so far
+    long bulkValuesLeft = 0;
+    bool bulkSkipping = false;      // the header was too large: the numbers are dropped, not parsed
+};
+
+// Executes the framed commands of one connection against the graph the connection picked from the
+// registry: queries on a snapshot, changes through GraphRegistry::update so they are charged to the
+// quotas. Its own state is the name of that graph and the edge list that follows a Newgraph command.
+class ClientSession {
+public:
+    // pipeline is the server's solve pipeline if it has one, for the Stats command
+    ClientSession(GraphRegistry& graphs, const SolvePipeline* pipeline = nullptr);
+
+    // Run one command and return the text for the client, empty if the command has no reply
+    std::string execute(std::string_view command);
+
+    // Run one frame of the binary protocol and return the reply frame (there always is one)
+    std::string executeFrame(const std::string& frame);
+
+    // True while the lines that follow a Newgraph command are its edges
+    bool expectsEdges() const;
+
+    // True if the command (a frame if binary) changes a graph or the session: the edges of a
+    // Newgraph, Newedge, Removeedge, Use, Dropgraph and the binary graph frames. Anything else only
+    // reads, so a pipelining server may run it next to the other readers of the same connection.
+    // Only valid while no command of this session that changes state is running
+    bool mutates(std::string_view command, bool binary) const;
+
+    // The graph the session works on, nullptr if it was dropped and not created again since.
+    // Safe to call from the parallel readers of one connection
+    std::shared_ptr<NamedGraph> currentGraph() const;
+
+private:
+    std::string addExpectedEdge(std::string_view command);
+    std::string newGraph(Tokenizer& tokens, std::string_view command);
+    std::string useGraph(std::string_view name);
+    std::string submitJob(std::string_view algorithm, const std::shared_ptr<NamedGraph>& named, GraphSnapshot graph);
+    std::string jobResponse(uint64_t job, bool result) const;
+    GraphSnapshot snapshot() const;
+    std::string noGraph() const;
+    std::string refused(const NamedGraph& graph) const;
+
+    GraphRegistry& graphs;
+    const SolvePipeline* pipeline;
+    std::string currentName;
+    mutable std::shared_ptr<NamedGraph> current;    // std::atomic_load/atomic_store only, see currentGraph
+    int expectedEdges;
+};
+
+#endif // SERVER_SESSION_HPP
@@ -0,0 +1,158 @@
+#include "SolvePipeline.hpp"
+#include "CommandParser.hpp"
+#include <iostream>
+#include <exception>
+#include <chrono>
+#include <future>
+
+SolvePipeline::SolvePipeline()
+    : waiter("wait"), renderer("render"), measurer("metrics"), solver("solve"), parser("parse") {}
+
+SolvePipeline::~SolvePipeline() {}
+
+bool SolvePipeline::handles(std::string_view command) {
+    Tokenizer tokens(command);
+    std::string_view name;
+    tokens.next(name);
+    CommandId id = commandId(name);
+    return id == CMD_BORUVKA || id == CMD_PRIM || id == CMD_KRUSKAL;
+}
+
+void SolvePipeline::submit(const std::string& command, std::shared_ptr<NamedGraph> graph, Reply reply) {
+    RequestPtr request = std::make_shared<Request>();
+    request->command = command;
+    request->results = graph->results;
+    request->named = std::move(graph);
+    request->reply = std::move(reply);
+    request->leader = false;
+    request->failed = false;
+    parser.send([this, request] { parse(request); });
+}
+
+std::string SolvePipeline::statsResponse() const {
+    std::string response = "Pipeline stages (queued, done):\n";
+    for (const ActiveObject* stage : {&parser, &solver, &measurer, &renderer, &waiter}) {
+        response += stage->getName() + ": " + std::to_string(stage->depth()) + ", " + std::to_string(stage->processed()) + "\n";
+    }
+    return response;
+}
+
+// ---------------------------- Stages ----------------------------
+void SolvePipeline::parse(RequestPtr request) {
+    Tokenizer tokens(request->command);
+    std::string_view name;
+    tokens.next(name);
+    CommandId id = commandId(name);
+    if (id == CMD_BORUVKA) {
+        request->type = MSTFactory::BORUVKA;
+    } else if (id == CMD_PRIM) {
+        request->type = MSTFactory::PRIM;
+    } else if (id == CMD_KRUSKAL) {
+        request->type = MSTFactory::PARALLEL_KRUSKAL;
+    } else {
+        std::cout << "Unknown command.\n";
+        request->reply("");
+        return;
+    }
+
+    // a result that is already there needs none of the other stages
+    request->graph = request->named->store.snapshot();
+    request->named.reset();
+    request->generation = request->graph->getGeneration();
+    std::shared_ptr<const SolveResult> cached = request->results->find(request->generation, request->type);
+    if (cached) {
+        request->reply(cached->response);
+        return;
+    }
+    solver.send([this, request] { solve(request); });
+}
+
+void SolvePipeline::solve(RequestPtr request) {
+    // the snapshot is the generation the request was parsed against, other clients may change the
+    // graph meanwhile
+    ResultCache::Flight flight = request->results->join(request->generation, request->type);
+    request->leader = flight.leader;
+    request->shared = flight.result;
+    FlightKey key(request->generation, request->type);
+    if (!request->leader && flight.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        std::lock_guard<std::mutex> lock(ledMutex);
+        if (!led.count(key)) {
+            // led outside the pipeline: nothing ahead of the request here will finish it
+            request->graph.reset();
+            waiter.send([this, request] { await(request); });
+            return;
+        }
+    }
+    if (request->leader) {
+        {
+            std::lock_guard<std::mutex> lock(ledMutex);
+            led.insert(key);
+        }
+        try {
+            request->mst = MSTFactory::createSolver(request->type)->solve(*request->graph);
+        } catch (...) {
+            std::cerr << "Solve failed\n";
+            request->results->abandon(request->generation, request->type, std::current_exception());
+            request->failed = true;
+        }
+    }
+    request->graph.reset();
+    measurer.send([this, request] { measure(request); });
+}
+
+void SolvePipeline::measure(RequestPtr request) {
+    if (request->leader && !request->failed) {
+        try {
+            request->metrics = computeMetrics(request->mst);
+        } catch (...) {
+            std::cerr << "Solve failed\n";
+            request->results->abandon(request->generation, request->type, std::current_exception());
+            request->failed = true;
+        }
+    }
+    renderer.send([this, request] { render(request); });
+}
+
+void SolvePipeline::render(RequestPtr request) {
+    if (request->leader) {
+        // the flight is completed or abandoned below (or was abandoned already): a later request
+        // that finds it still running is led elsewhere
+        std::lock_guard<std::mutex> lock(ledMutex);
+        led.erase(FlightKey(request->generation, request->type));
+    }
+    if (request->failed) {
+        request->reply("");
+        return;
+    }
+    if (request->leader) {
+        std::shared_ptr<const SolveResult> result;
+        try {
+            result = makeSolveResult(std::move(request->mst), std::move(request->metrics), request->type);
+        } catch (...) {
+            std::cerr << "Solve failed\n";
+            request->results->abandon(request->generation, request->type, std::current_exception());
+            request->reply("");
+            return;
+        }
+        request->results->complete(request->generation, request->type, result);
+        request->reply(result->response);
+        return;
+    }
+    // the flight was led by an earlier request of this pipeline, rendered already, or had finished
+    // when the request joined it
+    try {
+        request->reply(request->shared.get()->response);
+    } catch (...) {
+        std::cerr << "Solve failed\n";
+        request->reply("");
+    }
+}
+
+void SolvePipeline::await(RequestPtr request) {
+    try {
+        request->reply(request->shared.get()->response);
+    } catch (...) {
+        std::cerr << "Solve failed\n";
+        request->reply("");
+    }
+}
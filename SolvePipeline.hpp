@@ -0,0 +1,86 @@
+#ifndef SOLVE_PIPELINE_HPP
+#define SOLVE_PIPELINE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <set>
+#include <mutex>
+#include <utility>
+#include "Graph.hpp"
+#include "GraphRegistry.hpp"
+#include "MSTFactory.hpp"
+#include "TreeMetrics.hpp"
+#include "ResultCache.hpp"
+#include "ActiveObject.hpp"
+
+// MST requests ("Boruvka" / "Prim" / "Kruskal") as a pipeline of four active objects:
+//   parse   - command to algorithm, answered right away on a cache hit
+//   solve   - joins the single-flight cache and, as the leader, solves the graph snapshot
+//   metrics - metrics of the solved tree
+//   render  - response text, stores the result and replies
+// Each stage works on a different request at the same time, so a slow solve only holds up the
+// solves queued behind it: finished trees are still measured and rendered meanwhile.
+//
+// Every request that misses the cache passes every stage in order (a stage with nothing to do for
+// it just forwards it). A request that waits for the flight of an earlier one is therefore always
+// rendered after that one, and the render stage never waits for a result that is stuck behind it.
+// A flight led outside the pipeline (a worker's getMST, a background job) may still be solving:
+// its followers wait for it on a stage of their own, "wait", so none of the four stages blocks.
+class SolvePipeline {
+public:
+    // Called on a pipeline thread with the response, empty if the command failed
+    typedef std::function<void(const std::string&)> Reply;
+
+    SolvePipeline();
+    // Finishes the requests already submitted
+    ~SolvePipeline();
+
+    // True for the commands the pipeline handles
+    static bool handles(std::string_view command);
+
+    // Solve the command on the graph (kept alive until the parser took its snapshot even if it is
+    // dropped meanwhile), through the result cache of the graph
+    void submit(const std::string& command, std::shared_ptr<NamedGraph> graph, Reply reply);
+
+    // "Stats" - queue depth and finished requests of every stage
+    std::string statsResponse() const;
+
+private:
+    struct Request {
+        std::string command;
+        Reply reply;
+        std::shared_ptr<NamedGraph> named;
+        std::shared_ptr<ResultCache> results;   // of the graph, outlives a drop like the snapshot
+        MSTFactory::MSTType type;
+        GraphSnapshot graph;                    // taken by the parser, solved without a lock
+        unsigned long long generation;
+        bool leader;                            // computes the result for the flight
+        ResultCache::SharedResult shared;       // result of the flight when not the leader
+        std::vector<Edge> mst;
+        MetricsResult metrics;
+        bool failed;
+    };
+    typedef std::shared_ptr<Request> RequestPtr;
+
+    void parse(RequestPtr request);
+    void solve(RequestPtr request);
+    void measure(RequestPtr request);
+    void render(RequestPtr request);
+    void await(RequestPtr request);
+
+    typedef std::pair<unsigned long long, MSTFactory::MSTType> FlightKey;
+    std::mutex ledMutex;
+    std::set<FlightKey> led;                    // flights led by a request in the pipeline
+
+    // destroyed from the last one: every stage is drained before the one it feeds stops
+    ActiveObject waiter;
+    ActiveObject renderer;
+    ActiveObject measurer;
+    ActiveObject solver;
+    ActiveObject parser;
+};
+
+#endif // SOLVE_PIPELINE_HPP
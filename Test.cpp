@@ -5,6 +5,44 @@
 #include "Graph.hpp"
 #include "MSTFactory.hpp"
 #include "MSTSolver.hpp"
+#include "MSTClustering.hpp"
+#include "BoruvkaKernels.hpp"
+#include "BatchSolver.hpp"
+#include "Bottleneck.hpp"
+#include "TreeMetrics.hpp"
+#include "TreePathIndex.hpp"
+#include "DistanceSampling.hpp"
+#include "WeightHistogram.hpp"
+#include "ResultCache.hpp"
+#include "DynamicTreeMetrics.hpp"
+#include "ServerSession.hpp"
+#include "LeaderFollower.hpp"
+#include "Reactor.hpp"
+#include "ActiveObject.hpp"
+#include "SolvePipeline.hpp"
+#include "WireProtocol.hpp"
+#include "CommandParser.hpp"
+#include "GraphStore.hpp"
+#include "GraphRegistry.hpp"
+#include "JobStore.hpp"
+#include "ServerCommands.hpp"
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <cmath>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <future>
+#include <set>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
 
 TEST_CASE ("Test Non-connected graph") {
     // Based on test from https://www.geeksforgeeks.org/boruvkas-algorithm-greedy-algo-9/
@@ -128,4 +166,1415 @@ TEST_CASE ("Connected graph") {
         std::cout << "Edge: " << edge.u << " -> " << edge.v << " (" << edge.weight << ")\n";        // for debugging
         CHECK(found);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE ("Single-linkage clustering from the MST") {
+    Graph g(6);
+    g.addEdge(0, 1, 1);
+    g.addEdge(1, 2, 2);
+    g.addEdge(2, 3, 10);
+    g.addEdge(3, 4, 1);
+    g.addEdge(4, 5, 3);
+    g.addEdge(0, 5, 20);
+
+    std::vector<Edge> mst = MSTFactory::createSolver(MSTFactory::MSTType::PRIM)->solve(g);
+    Dendrogram dendrogram(g.getNumVertices(), mst);
+
+    CHECK(dendrogram.getMerges().size() == 5);
+    CHECK(dendrogram.getMerges().back().weight == 10);
+    CHECK(dendrogram.getMerges().back().size == 6);
+
+    // two clusters: {0,1,2} and {3,4,5}
+    std::vector<int> labels = dendrogram.clustersK(2);
+    CHECK(labels == std::vector<int>{0, 0, 0, 1, 1, 1});
+
+    // cutting at 2 keeps edges of weight 1 and 2 only
+    labels = dendrogram.clustersAtThreshold(2);
+    CHECK(labels == std::vector<int>{0, 0, 0, 1, 1, 2});
+
+    CHECK(dendrogram.clustersK(1) == std::vector<int>(6, 0));
+    CHECK(dendrogram.clustersK(6) == std::vector<int>{0, 1, 2, 3, 4, 5});
+    CHECK(dendrogram.clustersAtThreshold(0) == dendrogram.clustersK(6));
+
+    // a disconnected graph has no MST, the queries run on its minimum spanning forest
+    Graph split(3);
+    split.addEdge(1, 2, 4);
+    CHECK(ParallelKruskalSolver().spanningForest(split).size() == 1);
+    CHECK(ParallelKruskalSolver().solve(split).empty());
+    // k is clamped to the number of components
+    GraphCaches caches;
+    CHECK(clusterResponse(split, caches, 1) == "Single-linkage clustering (k=1):\nClusters: 2\nCluster 0: 0\nCluster 1: 1 2\n");
+    CHECK(clusterResponse(split, caches, 2) == "Single-linkage clustering (k=2):\nClusters: 2\nCluster 0: 0\nCluster 1: 1 2\n");
+    CHECK(pathResponse(split, caches, {{1, 2}, {0, 1}}) == "MST paths:\n1 2: distance 4, max edge 4\n0 1: not connected\n");
+    CHECK(minimaxResponse(split, caches, {{2, 1}, {0, 2}}) == "Minimax path weights:\n2 1: 4\n0 2: not connected\n");
+}
+
+
+TEST_CASE ("Vectorized Boruvka cheapest-edge reduction") {
+    std::srand(42);
+    const int numVertices = 200;
+    const int numEdges = 1003;      // not a multiple of the vector width, exercises the tail
+    std::vector<int> eu(numEdges), ev(numEdges), ew(numEdges), comp(numVertices);
+    for (int i = 0; i < numEdges; ++i) {
+        eu[i] = std::rand() % numVertices;
+        ev[i] = std::rand() % numVertices;
+        ew[i] = std::rand() % 50 - 10;      // negative weights and lots of ties
+    }
+    for (int v = 0; v < numVertices; ++v) {
+        comp[v] = v % 17;
+    }
+
+    std::vector<uint64_t> expected(numVertices, std::numeric_limits<uint64_t>::max());
+    std::vector<uint64_t> actual(numVertices, std::numeric_limits<uint64_t>::max());
+    cheapestEdgesScalar(eu.data(), ev.data(), ew.data(), numEdges, comp.data(), expected.data());
+    cheapestEdges(eu.data(), ev.data(), ew.data(), numEdges, comp.data(), actual.data());
+    std::cout << "Borůvka kernel: " << cheapestEdgesKernel() << "\n";
+    CHECK(expected == actual);
+
+    // Boruvka and Prim must agree on the MST weight
+    Graph g(numVertices);
+    for (int v = 1; v < numVertices; ++v) {
+        g.addEdge(v, std::rand() % v, std::rand() % 100);
+    }
+    for (int i = 0; i < numEdges; ++i) {
+        g.addEdge(eu[i], ev[i], ew[i]);
+    }
+    std::vector<Edge> boruvka = MSTFactory::createSolver(MSTFactory::MSTType::BORUVKA)->solve(g);
+    std::vector<Edge> prim = MSTFactory::createSolver(MSTFactory::MSTType::PRIM)->solve(g);
+    long long boruvkaWeight = 0, primWeight = 0;
+    for (const Edge& edge : boruvka) boruvkaWeight += edge.weight;
+    for (const Edge& edge : prim) primWeight += edge.weight;
+    CHECK(boruvka.size() == numVertices - 1);
+    CHECK(boruvkaWeight == primWeight);
+}
+
+
+TEST_CASE ("Parallel Kruskal with sample sort") {
+    std::srand(7);
+    const int numVertices = 3000;
+    Graph g(numVertices);
+    for (int v = 1; v < numVertices; ++v) {
+        g.addEdge(v, std::rand() % v, std::rand() % 1000);
+    }
+    for (int i = 0; i < 20000; ++i) {
+        g.addEdge(std::rand() % numVertices, std::rand() % numVertices, std::rand() % 1000);
+    }
+
+    // force the parallel path of the sort on a small input
+    std::vector<Edge> edges = g.getEdges();
+    std::vector<Edge> expected = edges;
+    parallelSortEdges(edges, computePool(), 1);
+    std::stable_sort(expected.begin(), expected.end(), [](const Edge& a, const Edge& b) {
+        return a.weight < b.weight || (a.weight == b.weight && (a.u < b.u || (a.u == b.u && a.v < b.v)));
+    });
+    CHECK(edges.size() == expected.size());
+    bool sameOrder = true;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        sameOrder = sameOrder && edges[i].u == expected[i].u && edges[i].v == expected[i].v && edges[i].weight == expected[i].weight;
+    }
+    CHECK(sameOrder);
+
+    std::vector<Edge> kruskal = MSTFactory::createSolver(MSTFactory::MSTType::PARALLEL_KRUSKAL)->solve(g);
+    std::vector<Edge> prim = MSTFactory::createSolver(MSTFactory::MSTType::PRIM)->solve(g);
+    long long kruskalWeight = 0, primWeight = 0;
+    for (const Edge& edge : kruskal) kruskalWeight += edge.weight;
+    for (const Edge& edge : prim) primWeight += edge.weight;
+    CHECK(kruskal.size() == numVertices - 1);
+    CHECK(kruskalWeight == primWeight);
+
+    // disconnected graph has no spanning tree
+    Graph disconnected(4);
+    disconnected.addEdge(0, 1, 1);
+    disconnected.addEdge(2, 3, 1);
+    CHECK(MSTFactory::createSolver(MSTFactory::MSTType::PARALLEL_KRUSKAL)->solve(disconnected).empty());
+}
+
+
+TEST_CASE ("Batch solving of small graphs") {
+    std::srand(11);
+    GraphBatch batch;
+    std::vector<Graph> graphs;
+    for (int g = 0; g < 300; ++g) {
+        // mostly tiny graphs, a few above the bitset limit and a few disconnected ones
+        int numVertices = g % 50 == 0 ? 80 : 1 + std::rand() % MAX_BATCH_VERTICES;
+        bool connected = g % 7 != 0;
+        graphs.emplace_back(numVertices);
+        std::vector<Edge> edges;
+        for (int v = 1; v < numVertices; ++v) {
+            if (connected || v != numVertices / 2) {
+                edges.push_back(Edge(v, std::rand() % v, std::rand() % 20));
+            }
+        }
+        for (int i = 0; i < numVertices; ++i) {
+            int u = std::rand() % numVertices, v = std::rand() % numVertices;
+            if (connected || ((u < numVertices / 2) == (v < numVertices / 2))) {
+                edges.push_back(Edge(u, v, std::rand() % 20));
+            }
+        }
+        for (const Edge& edge : edges) {
+            graphs.back().addEdge(edge.u, edge.v, edge.weight);
+        }
+        batch.addGraph(numVertices, edges);
+    }
+
+    BatchResult result = solveBatch(batch);
+    bool allMatch = true;
+    for (size_t g = 0; g < graphs.size(); ++g) {
+        int numVertices = graphs[g].getNumVertices();
+        if (numVertices == 1) {
+            allMatch = allMatch && result.connected[g] && result.mstSizes[g] == 0;
+            continue;
+        }
+        std::vector<Edge> mst = MSTFactory::createSolver(MSTFactory::MSTType::PRIM)->solve(graphs[g]);
+        long long weight = 0;
+        for (const Edge& edge : mst) weight += edge.weight;
+        allMatch = allMatch && (result.connected[g] != 0) == !mst.empty();
+        allMatch = allMatch && result.mstSizes[g] == static_cast<int>(mst.size());
+        allMatch = allMatch && result.totalWeights[g] == weight;
+    }
+    CHECK(allMatch);
+
+    // through the server: a graph too large for a batch, or a batch over the budget, is refused
+    // from its header, before anything is allocated
+    GraphRegistry registry;
+    ClientSession session(registry);
+    CHECK(session.execute("Batch 2\n2 1 0 1 5\n3 0") == "Batch results for 2 graphs:\nGraph 0: weight 5, 0-1(5)\nGraph 1: not connected\n");
+    CHECK(session.execute("Batch 1\n100000000 0").find("Error: Graph 0 of the batch has more than") == 0);
+    CHECK(session.execute("Batch 2\n3 0\n1000 100000000").find("Error: Batch exceeds") == 0);
+}
+
+
+TEST_CASE ("Bottleneck spanning tree and minimax queries") {
+    std::srand(5);
+    const int numVertices = 40;
+    Graph g(numVertices);
+    for (int v = 1; v < numVertices; ++v) {
+        g.addEdge(v, std::rand() % v, std::rand() % 100);
+    }
+    for (int i = 0; i < 150; ++i) {
+        g.addEdge(std::rand() % numVertices, std::rand() % numVertices, std::rand() % 100);
+    }
+
+    // every MST is also a minimum bottleneck spanning tree
+    std::vector<Edge> mst = MSTFactory::createSolver(MSTFactory::MSTType::PRIM)->solve(g);
+    std::vector<Edge> tree = bottleneckSpanningTree(g);
+    CHECK(tree.size() == numVertices - 1);
+    CHECK(bottleneckWeight(tree) == bottleneckWeight(mst));
+
+    // minimax(u, v) is the first weight at which u and v get connected when adding edges by weight
+    std::vector<Edge> sorted = g.getEdges();
+    std::sort(sorted.begin(), sorted.end(), [](const Edge& a, const Edge& b) { return a.weight < b.weight; });
+    MinimaxIndex index(Dendrogram(numVertices, mst));
+    bool allMatch = true;
+    for (int u = 0; u < numVertices; ++u) {
+        for (int v = u + 1; v < numVertices; ++v) {
+            std::vector<int> parent(numVertices), rank(numVertices, 0);
+            for (int i = 0; i < numVertices; ++i) parent[i] = i;
+            int expected = -1;
+            for (const Edge& edge : sorted) {
+                if (find(parent, edge.u) != find(parent, edge.v)) {
+                    unionSets(parent, rank, find(parent, edge.u), find(parent, edge.v));
+                }
+                if (find(parent, u) == find(parent, v)) {
+                    expected = edge.weight;
+                    break;
+                }
+            }
+            int weight;
+            allMatch = allMatch && index.query(u, v, weight) && weight == expected;
+        }
+    }
+    CHECK(allMatch);
+
+    Graph disconnected(4);
+    disconnected.addEdge(0, 1, 1);
+    disconnected.addEdge(2, 3, 1);
+    CHECK(bottleneckSpanningTree(disconnected).empty());
+}
+
+
+TEST_CASE ("Tree distance metrics") {
+    // path 0 -1- 1 -2- 2 -3- 3 plus a leaf 4 hanging from 1 with weight 10
+    std::vector<Edge> tree = {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {1, 4, 10}};
+    std::unique_ptr<MSTSolver> solver = MSTFactory::createSolver(MSTFactory::MSTType::PRIM);
+
+    CHECK(solver->totalWeight(tree) == 16);
+    CHECK(solver->longestDistance(tree) == 15);     // 4 -> 3
+    CHECK(solver->shortestDistance(tree) == 1);
+    // all pairs: 1+3+6+11 + 2+5+10 + 3+12 + 15 = 68, over 5*6/2 = 15 pairs (j >= i)
+    CHECK(solver->averageDistance(tree) == doctest::Approx(68.0 / 15));
+
+    // random tree against all-pairs BFS
+    std::srand(3);
+    const int numVertices = 300;
+    std::vector<Edge> randomTree;
+    for (int v = 1; v < numVertices; ++v) {
+        randomTree.push_back(Edge(std::rand() % v, v, std::rand() % 1000));
+    }
+    TreeAdjacency adjacency(randomTree);
+    long long diameter = 0, sum = 0;
+    for (int v = 0; v < numVertices; ++v) {
+        std::vector<long long> distance = treeDistances(adjacency, v);
+        for (int u = v + 1; u < numVertices; ++u) {
+            diameter = std::max(diameter, distance[u]);
+            sum += distance[u];
+        }
+    }
+    CHECK(treeDiameter(adjacency) == diameter);
+    CHECK(pairwiseDistanceSum(adjacency) == sum);
+}
+
+
+TEST_CASE ("Fused metrics pass") {
+    std::vector<Edge> tree = {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {1, 4, 10}};
+    MetricsResult metrics = computeMetrics(tree);
+    CHECK(metrics.numVertices == 5);
+    CHECK(metrics.totalWeight == 16);
+    CHECK(metrics.minEdgeWeight == 1);
+    CHECK(metrics.maxEdgeWeight == 10);
+    CHECK(metrics.diameter == 15);
+    CHECK(metrics.pairwiseDistanceSum == 68);
+    CHECK(metrics.averageDistance == doctest::Approx(68.0 / 15));
+    CHECK(metrics.minDegree == 1);
+    CHECK(metrics.maxDegree == 3);
+    CHECK(metrics.numLeaves == 3);
+    CHECK(metrics.averageDegree == doctest::Approx(8.0 / 5));
+
+    // same numbers as the separate metric functions on a random tree
+    std::srand(9);
+    std::vector<Edge> randomTree;
+    for (int v = 1; v < 2000; ++v) {
+        randomTree.push_back(Edge(v, std::rand() % v, std::rand() % 1000));
+    }
+    std::unique_ptr<MSTSolver> solver = MSTFactory::createSolver(MSTFactory::MSTType::PRIM);
+    metrics = solver->metrics(randomTree);
+    CHECK(metrics.totalWeight == solver->totalWeight(randomTree));
+    CHECK(metrics.diameter == solver->longestDistance(randomTree));
+    CHECK(metrics.minEdgeWeight == solver->shortestDistance(randomTree));
+    CHECK(metrics.averageDistance == doctest::Approx(solver->averageDistance(randomTree)));
+}
+
+
+TEST_CASE ("Tree path queries") {
+    std::srand(13);
+    const int numVertices = 200;
+    std::vector<Edge> tree;
+    for (int v = 1; v < numVertices; ++v) {
+        tree.push_back(Edge(std::rand() % v, v, std::rand() % 1000));
+    }
+    // vertex numVertices is isolated (e.g. a disconnected graph)
+    TreePathIndex index(numVertices + 1, tree);
+
+    // compare with a walk from every source, tracking distance and heaviest edge
+    TreeAdjacency adjacency(tree);
+    bool allMatch = true;
+    for (int source = 0; source < numVertices; source += 7) {
+        std::vector<long long> distance = treeDistances(adjacency, source);
+        std::vector<int> heaviest(numVertices, 0);
+        std::vector<int> stack = {source};
+        std::vector<char> seen(numVertices, 0);
+        seen[source] = 1;
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            for (int i = adjacency.start[u]; i < adjacency.start[u + 1]; ++i) {
+                int v = adjacency.neighbor[i];
+                if (!seen[v]) {
+                    seen[v] = 1;
+                    heaviest[v] = std::max(u == source ? adjacency.weight[i] : heaviest[u], adjacency.weight[i]);
+                    stack.push_back(v);
+                }
+            }
+        }
+        for (int v = 0; v < numVertices; ++v) {
+            long long d;
+            int m;
+            allMatch = allMatch && index.distance(source, v, d) && d == distance[v];
+            allMatch = allMatch && index.pathMax(source, v, m) && m == heaviest[v];
+        }
+    }
+    CHECK(allMatch);
+
+    long long d;
+    CHECK(!index.distance(0, numVertices, d));
+    CHECK(index.distance(numVertices, numVertices, d));
+    CHECK(d == 0);
+}
+
+
+TEST_CASE ("Parallel tree metrics") {
+    std::srand(17);
+    for (int shape = 0; shape < 3; ++shape) {
+        // random tree, long path, star
+        std::vector<Edge> tree;
+        for (int v = 1; v < 5000; ++v) {
+            int parent = shape == 0 ? std::rand() % v : shape == 1 ? v - 1 : 0;
+            tree.push_back(Edge(v, parent, std::rand() % 1000));
+        }
+        MetricsResult sequential = computeMetrics(tree);
+        MetricsResult parallel = computeMetricsParallel(tree);
+        CHECK(parallel.numVertices == sequential.numVertices);
+        CHECK(parallel.totalWeight == sequential.totalWeight);
+        CHECK(parallel.minEdgeWeight == sequential.minEdgeWeight);
+        CHECK(parallel.maxEdgeWeight == sequential.maxEdgeWeight);
+        CHECK(parallel.diameter == sequential.diameter);
+        CHECK(parallel.pairwiseDistanceSum == sequential.pairwiseDistanceSum);
+        CHECK(parallel.minDegree == sequential.minDegree);
+        CHECK(parallel.maxDegree == sequential.maxDegree);
+        CHECK(parallel.numLeaves == sequential.numLeaves);
+        CHECK(parallel.weightHistogram.quantile(0.9) == sequential.weightHistogram.quantile(0.9));
+    }
+
+    // a forest falls back to the sequential pass
+    std::vector<Edge> forest = {{0, 1, 3}, {2, 3, 4}};
+    CHECK(computeMetricsParallel(forest).pairwiseDistanceSum == computeMetrics(forest).pairwiseDistanceSum);
+    std::vector<Edge> gap = {{0, 1, 3}, {1, 3, 4}};
+    CHECK(computeMetricsParallel(gap).pairwiseDistanceSum == computeMetrics(gap).pairwiseDistanceSum);
+}
+
+
+TEST_CASE ("Tree center and eccentricities") {
+    // eccentricities: 0 -> 11, 1 -> 10, 2 -> 12, 3 -> 15, 4 -> 15
+    std::vector<Edge> tree = {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {1, 4, 10}};
+    MetricsResult metrics = computeMetrics(tree);
+    CHECK(metrics.radius == 10);
+    CHECK(metrics.centers == std::vector<int>{1});
+    // 6 possible values 10..15 over 10 buckets
+    CHECK(metrics.eccentricityHistogram == std::vector<int>{1, 1, 0, 1, 0, 0, 0, 0, 2, 0});
+
+    // two centers on an even path with equal weights
+    std::vector<Edge> path = {{0, 1, 2}, {1, 2, 2}, {2, 3, 2}};
+    CHECK(computeMetrics(path).centers == std::vector<int>{1, 2});
+
+    // random trees against BFS from every vertex, sequential and parallel
+    std::srand(21);
+    for (int shape = 0; shape < 3; ++shape) {
+        std::vector<Edge> randomTree;
+        for (int v = 1; v < 800; ++v) {
+            int parent = shape == 0 ? std::rand() % v : shape == 1 ? v - 1 : std::rand() % std::min(v, 5);
+            randomTree.push_back(Edge(parent, v, std::rand() % 100));
+        }
+        TreeAdjacency adjacency(randomTree);
+        std::vector<long long> eccentricity(adjacency.num_vertices);
+        for (int v = 0; v < adjacency.num_vertices; ++v) {
+            std::vector<long long> distance = treeDistances(adjacency, v);
+            eccentricity[v] = *std::max_element(distance.begin(), distance.end());
+        }
+        long long radius = *std::min_element(eccentricity.begin(), eccentricity.end());
+        long long diameter = *std::max_element(eccentricity.begin(), eccentricity.end());
+        std::vector<int> centers;
+        std::vector<int> histogram(ECCENTRICITY_BUCKETS, 0);
+        for (int v = 0; v < adjacency.num_vertices; ++v) {
+            if (eccentricity[v] == radius) {
+                centers.push_back(v);
+            }
+            histogram[eccentricityBucket(eccentricity[v], radius, diameter)]++;
+        }
+
+        for (const MetricsResult& result : {computeMetrics(randomTree), computeMetricsParallel(randomTree)}) {
+            CHECK(result.radius == radius);
+            CHECK(result.diameter == diameter);
+            CHECK(result.centers == centers);
+            CHECK(result.eccentricityHistogram == histogram);
+        }
+    }
+}
+
+
+TEST_CASE ("Sampled distance statistics") {
+    std::srand(25);
+    const int numVertices = 120;
+    Graph graph(numVertices);
+    for (int v = 1; v < numVertices; ++v) {
+        graph.addEdge(std::rand() % v, v, 1 + std::rand() % 50);
+    }
+    for (int i = 0; i < 200; ++i) {
+        graph.addEdge(std::rand() % numVertices, std::rand() % numVertices, 1 + std::rand() % 50);
+    }
+    GraphCSR snapshot(graph);
+    CHECK(snapshot.neighbor.size() == graph.getEdges().size());
+
+    // exact all-pairs distances with Floyd-Warshall
+    const long long INF = LLONG_MAX / 4;
+    std::vector<std::vector<long long>> distance(numVertices, std::vector<long long>(numVertices, INF));
+    for (int v = 0; v < numVertices; ++v) {
+        distance[v][v] = 0;
+    }
+    for (const Edge& edge : graph.getEdges()) {
+        distance[edge.u][edge.v] = edge.weight;
+    }
+    for (int k = 0; k < numVertices; ++k) {
+        for (int i = 0; i < numVertices; ++i) {
+            for (int j = 0; j < numVertices; ++j) {
+                distance[i][j] = std::min(distance[i][j], distance[i][k] + distance[k][j]);
+            }
+        }
+    }
+    std::vector<long long> all;
+    for (int i = 0; i < numVertices; ++i) {
+        for (int j = 0; j < numVertices; ++j) {
+            if (i != j) {
+                all.push_back(distance[i][j]);
+            }
+        }
+    }
+    std::sort(all.begin(), all.end());
+    double exactMean = std::accumulate(all.begin(), all.end(), 0.0) / all.size();
+
+    // every vertex as a source: exact values, zero-width intervals
+    DistanceSample sample;
+    REQUIRE(sampleDistances(snapshot, numVertices, 1, sample));
+    CHECK(sample.numPairs == static_cast<long long>(all.size()));
+    CHECK(sample.unreachablePairs == 0);
+    CHECK(sample.mean.value == doctest::Approx(exactMean));
+    CHECK(sample.mean.high - sample.mean.low == doctest::Approx(0));
+    CHECK(sample.median.value == all[all.size() / 2 - 1]);
+    CHECK(sample.p99.value == all[static_cast<size_t>(std::ceil(0.99 * all.size())) - 1]);
+
+    // a quarter of the sources: estimates inside their intervals, the exact mean close by
+    REQUIRE(sampleDistances(snapshot, 30, 7, sample));
+    CHECK(sample.numSources == 30);
+    CHECK(sample.mean.low <= sample.mean.value);
+    CHECK(sample.mean.value <= sample.mean.high);
+    CHECK(sample.median.low <= sample.median.value);
+    CHECK(sample.median.value <= sample.median.high);
+    CHECK(std::abs(sample.mean.value - exactMean) < 2 * (sample.mean.high - sample.mean.low));
+    CHECK(printDistanceSample(sample).find("capped") == std::string::npos);
+
+    // more sources than the distance budget holds: capped, and the response says so
+    REQUIRE(sampleDistances(snapshot, 30, 7, sample, computePool(), 10 * numVertices));
+    CHECK(sample.numSources == 10);
+    CHECK(sample.requestedSources == 30);
+    CHECK(printDistanceSample(sample).find("Distance sample: 10 sources (capped from 30 by the memory budget)") == 0);
+
+    // unreachable pairs and negative weights
+    Graph split(4);
+    split.addEdge(0, 1, 5);
+    split.addEdge(2, 3, 7);
+    REQUIRE(sampleDistances(GraphCSR(split), 4, 3, sample));
+    CHECK(sample.numPairs == 4);
+    CHECK(sample.unreachablePairs == 8);
+    CHECK(sample.mean.value == doctest::Approx(6));
+    split.addEdge(1, 2, -1);
+    CHECK(!sampleDistances(GraphCSR(split), 4, 3, sample));
+}
+
+
+TEST_CASE ("Edge weight histogram quantiles") {
+    WeightHistogram empty;
+    CHECK(empty.quantile(0.5) == 0);
+
+    // small weights have a bucket each: exact
+    WeightHistogram small;
+    for (int w = 1; w <= 10; ++w) {
+        small.record(w);
+    }
+    CHECK(small.quantile(0.5) == 5);
+    CHECK(small.quantile(0.9) == 9);
+    CHECK(small.quantile(1.0) == 10);
+    CHECK(small.quantile(0.0) == 1);
+
+    // random weights (some negative) against the sorted values, merged from two halves
+    std::srand(29);
+    std::vector<int> weights;
+    WeightHistogram first, second;
+    for (int i = 0; i < 5000; ++i) {
+        int w = std::rand() % 2000000 - 100000;
+        weights.push_back(w);
+        (i % 2 ? first : second).record(w);
+    }
+    first.merge(second);
+    CHECK(first.count() == 5000);
+    std::sort(weights.begin(), weights.end());
+    for (double q : {0.01, 0.25, 0.5, 0.9, 0.99}) {
+        int exact = weights[static_cast<size_t>(std::ceil(q * weights.size())) - 1];
+        CHECK(std::abs(first.quantile(q) - exact) <= std::abs(exact) / WeightHistogram::SUB_BUCKETS + 1);
+    }
+    CHECK(first.quantile(1.0) <= weights.back());
+    CHECK(first.quantile(0.0) >= weights.front());
+
+    // the metrics carry the histogram of the MST edges
+    std::vector<Edge> tree = {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {1, 4, 10}};
+    MetricsResult metrics = computeMetrics(tree);
+    CHECK(metrics.weightHistogram.count() == 4);
+    CHECK(metrics.weightHistogram.quantile(0.5) == 2);
+    CHECK(metrics.weightHistogram.quantile(1.0) == 10);
+}
+
+
+TEST_CASE ("Graph generation and result cache") {
+    Graph graph(3);
+    unsigned long long generation = graph.getGeneration();
+    graph.addEdge(0, 1, 4);
+    CHECK(graph.getGeneration() > generation);
+    generation = graph.getGeneration();
+    graph.addEdge(0, 5, 1);     // out of range, nothing changes
+    CHECK(graph.getGeneration() == generation);
+    graph.removeEdge(0, 1);
+    CHECK(graph.getGeneration() > generation);
+    generation = graph.getGeneration();
+    graph.resetGraph(3);        // a reset never goes back to an old generation
+    CHECK(graph.getGeneration() > generation);
+
+    graph.addEdge(0, 1, 4);
+    graph.addEdge(1, 2, 2);
+    generation = graph.getGeneration();
+    std::shared_ptr<const SolveResult> result =
+        makeSolveResult(MSTFactory::createSolver(MSTFactory::PRIM)->solve(graph), MSTFactory::PRIM);
+    CHECK(result->mst.size() == 2);
+    CHECK(result->metrics.totalWeight == 6);
+    CHECK(result->response.find("Minimum Spanning Tree (Prim):") == 0);
+    CHECK(result->response.find("Total weight: 6") != std::string::npos);
+
+    ResultCache cache;
+    CHECK(cache.find(generation, MSTFactory::PRIM) == nullptr);
+    cache.store(generation, MSTFactory::PRIM, result);
+    CHECK(cache.find(generation, MSTFactory::PRIM) == result);
+    CHECK(cache.find(generation, MSTFactory::BORUVKA) == nullptr);
+    CHECK(cache.find(generation + 1, MSTFactory::PRIM) == nullptr);
+
+    // a late result from an older generation does not replace a newer one
+    std::shared_ptr<const SolveResult> newer = makeSolveResult({Edge(0, 1, 1)}, MSTFactory::PRIM);
+    cache.store(generation + 1, MSTFactory::PRIM, newer);
+    cache.store(generation, MSTFactory::PRIM, result);
+    CHECK(cache.find(generation + 1, MSTFactory::PRIM) == newer);
+    CHECK(cache.find(generation, MSTFactory::PRIM) == nullptr);
+
+    // every graph has results of its own: solves alternating between two graphs stay cached
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    session.execute("Newgraph a 2 1");
+    session.execute("0 1 3");
+    session.execute("Newgraph b 2 1");
+    session.execute("0 1 5");
+    std::shared_ptr<NamedGraph> a = graphs.find("a");
+    std::shared_ptr<NamedGraph> b = graphs.find("b");
+    session.execute("Use a");
+    std::string solvedA = session.execute("Prim");
+    CHECK(solvedA.find("Total weight: 3") != std::string::npos);
+    std::shared_ptr<const SolveResult> cachedA = a->results->find(a->store.snapshot()->getGeneration(), MSTFactory::PRIM);
+    REQUIRE(cachedA != nullptr);
+    std::shared_ptr<const SolveResult> cachedB;
+    for (int i = 0; i < 3; ++i) {
+        session.execute("Use b");
+        CHECK(session.execute("Prim").find("Total weight: 5") != std::string::npos);
+        std::shared_ptr<const SolveResult> hitB = b->results->find(b->store.snapshot()->getGeneration(), MSTFactory::PRIM);
+        REQUIRE(hitB != nullptr);
+        CHECK((i == 0 || hitB == cachedB));
+        cachedB = hitB;
+        session.execute("Use a");
+        CHECK(session.execute("Prim") == solvedA);
+        CHECK(a->results->find(a->store.snapshot()->getGeneration(), MSTFactory::PRIM) == cachedA);
+    }
+}
+
+
+TEST_CASE ("Single-flight solves") {
+    ResultCache cache;
+    std::shared_ptr<const SolveResult> result = makeSolveResult({Edge(0, 1, 2)}, MSTFactory::BORUVKA);
+
+    // concurrent requests for one key: one leader computes, everybody gets its result
+    const int numThreads = 8;
+    std::atomic<int> leaders(0);
+    std::vector<std::shared_ptr<const SolveResult>> seen(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            ResultCache::Flight flight = cache.join(5, MSTFactory::BORUVKA);
+            if (flight.leader) {
+                leaders++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                cache.complete(5, MSTFactory::BORUVKA, result);
+            }
+            seen[t] = flight.result.get();
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(leaders == 1);
+    for (const std::shared_ptr<const SolveResult>& got : seen) {
+        CHECK(got == result);
+    }
+
+    // later requests are cache hits, other keys get their own flight
+    ResultCache::Flight hit = cache.join(5, MSTFactory::BORUVKA);
+    CHECK(!hit.leader);
+    CHECK(hit.result.get() == result);
+    CHECK(cache.join(6, MSTFactory::BORUVKA).leader);
+    CHECK(cache.join(5, MSTFactory::PRIM).leader);
+
+    // a failed leader passes the error on and leaves nothing behind
+    ResultCache::Flight waiter = cache.join(6, MSTFactory::BORUVKA);
+    CHECK(!waiter.leader);
+    cache.abandon(6, MSTFactory::BORUVKA, std::make_exception_ptr(std::runtime_error("solve failed")));
+    CHECK_THROWS_AS(waiter.result.get(), std::runtime_error);
+    CHECK(cache.join(6, MSTFactory::BORUVKA).leader);
+}
+
+
+TEST_CASE ("Incremental metrics under edge swaps") {
+    // path 0 -1- 1 -2- 2 -3- 3 plus 4 hanging from 1 with weight 10
+    std::vector<Edge> tree = {{0, 1, 1}, {1, 2, 2}, {2, 3, 3}, {1, 4, 10}};
+    DynamicTreeMetrics dynamic(5, tree);
+    CHECK(dynamic.isTree());
+    CHECK(dynamic.pairwiseDistanceSum() == 68);
+    CHECK(dynamic.diameter() == 15);
+    CHECK(dynamic.distanceSum(1) == 1 + 2 + 5 + 10);
+    int farthest;
+    CHECK(dynamic.eccentricity(0, &farthest) == 11);
+    CHECK(farthest == 4);
+
+    // 1-4 replaced by 3-4: 4 moves to the end of the path
+    CHECK(dynamic.swapEdge(1, 4, 3, 4, 1));
+    CHECK(dynamic.totalWeight() == 7);
+    CHECK(dynamic.diameter() == 7);
+    CHECK(dynamic.pairwiseDistanceSum() == computeMetrics(dynamic.getEdges()).pairwiseDistanceSum);
+
+    // not a tree edge, or an edge that stays on one side: nothing changes
+    CHECK(!dynamic.swapEdge(0, 2, 0, 4, 1));
+    CHECK(!dynamic.swapEdge(0, 1, 2, 4, 1));
+    CHECK(dynamic.getEdges().size() == 4);
+    CHECK(dynamic.pairwiseDistanceSum() == computeMetrics(dynamic.getEdges()).pairwiseDistanceSum);
+
+    // random swaps against the full pass, negative weights included
+    std::srand(31);
+    const int numVertices = 60;
+    std::vector<Edge> randomTree;
+    for (int v = 1; v < numVertices; ++v) {
+        randomTree.push_back(Edge(std::rand() % v, v, std::rand() % 100 - 10));
+    }
+    DynamicTreeMetrics randomDynamic(numVertices, randomTree);
+    bool allMatch = true;
+    for (int step = 0; step < 300; ++step) {
+        std::vector<Edge> edges = randomDynamic.getEdges();
+        const Edge& drop = edges[std::rand() % edges.size()];
+        randomDynamic.swapEdge(drop.u, drop.v, std::rand() % numVertices, std::rand() % numVertices, std::rand() % 100);
+        MetricsResult metrics = computeMetrics(randomDynamic.getEdges());
+        allMatch = allMatch && static_cast<int>(randomDynamic.getEdges().size()) == numVertices - 1;
+        allMatch = allMatch && metrics.totalWeight == randomDynamic.totalWeight();
+        allMatch = allMatch && metrics.pairwiseDistanceSum == randomDynamic.pairwiseDistanceSum();
+        allMatch = allMatch && metrics.diameter == randomDynamic.diameter();
+    }
+    CHECK(allMatch);
+}
+
+TEST_CASE ("Command framing and client sessions") {
+    // plain commands end with their line, a command without newline only once the data is complete
+    CommandFramer framer;
+    std::string command;
+    std::string input = "Newgraph 3 2\n0 1 4\n  Prim";
+    framer.feed(input.data(), input.size());
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Newgraph 3 2");
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "0 1 4");
+    CHECK_FALSE(framer.nextCommand(command, false));
+    CHECK(framer.nextCommand(command, true));
+    CHECK(command == "Prim");
+    CHECK(framer.buffered() == 0);
+
+    // list commands run over lines and recv calls until their counts are met
+    input = "Path 2 0 1\n";
+    framer.feed(input.data(), input.size());
+    CHECK_FALSE(framer.nextCommand(command, true));
+    input = "1 2\nKruskal\n";
+    framer.feed(input.data(), input.size());
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Path 2 0 1\n1 2");
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Kruskal");
+
+    // a number split between two recv calls is not taken early
+    input = "Batch 1 2 1 0 1 1";
+    framer.feed(input.data(), input.size());
+    CHECK_FALSE(framer.nextCommand(command, false));
+    input = "5\n";
+    framer.feed(input.data(), input.size());
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Batch 1 2 1 0 1 15");
+
+    // a malformed list ends with its line
+    input = "Minimax x\nBottleneck\n";
+    framer.feed(input.data(), input.size());
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Minimax x");
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Bottleneck");
+
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    CHECK(session.execute("Newgraph 3 2") == "Graph created. Send 2 edges (u v weight).\n");
+    CHECK(session.execute("0 1 4") == "Edge added. 1 edges remaining.\n");
+    CHECK(session.execute("1 2 6") == "Edge added. 0 edges remaining.\n");
+    CHECK(session.execute("Newedge 0 2 1").empty());
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getNumVertices() == 3);
+    std::string response = session.execute("Kruskal");
+    CHECK(response.find("Minimum Spanning Tree (Kruskal):") == 0);
+    CHECK(response.find("Total weight: 5") != std::string::npos);
+    CHECK(session.execute("Path 1\n1 2").find("1 2: distance 5") != std::string::npos);
+    CHECK(session.execute("Unknown 1").empty());
+}
+
+TEST_CASE ("Leader-Follower server threads") {
+    // listen on a free port of the loopback interface
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    REQUIRE(bind(listener, (sockaddr*) &address, sizeof(address)) == 0);
+    REQUIRE(listen(listener, SOMAXCONN) == 0);
+    socklen_t length = sizeof(address);
+    getsockname(listener, (sockaddr*) &address, &length);
+
+    GraphRegistry graphs;
+    LeaderFollowerPool pool(listener, graphs, 200);
+    std::thread serverThread([&pool] { pool.run(3, 1); });
+
+    // commands cut anywhere between segments wait for the rest, the replies come back in order
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(connect(client, (sockaddr*) &address, sizeof(address)) == 0);
+    for (const char* segment : {"Newgraph 3 2\n0 1 4\n1 2 ", "6\nPa", "th 1 0 2\n"}) {
+        send(client, segment, strlen(segment), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::string reply;
+    char buffer[1024];
+    while (reply.find("max edge") == std::string::npos) {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        REQUIRE(received > 0);
+        reply.append(buffer, received);
+    }
+    close(client);
+    CHECK(reply == "Graph created. Send 2 edges (u v weight).\nEdge added. 1 edges remaining.\n"
+                   "Edge added. 0 edges remaining.\nMST paths:\n0 2: distance 10, max edge 6\n");
+
+    // a client that never reads its replies is dropped once it left no room for them for the send
+    // timeout, instead of holding a thread
+    int stalled = socket(AF_INET, SOCK_STREAM, 0);
+    int smallBuffer = 4096;
+    setsockopt(stalled, SOL_SOCKET, SO_RCVBUF, &smallBuffer, sizeof(smallBuffer));
+    REQUIRE(connect(stalled, (sockaddr*) &address, sizeof(address)) == 0);
+    const int starVertices = 20000;
+    std::string upload = "Newgraph star " + std::to_string(starVertices) + " " + std::to_string(starVertices - 1) + " bulk\n";
+    for (int v = 1; v < starVertices; ++v) {
+        upload += "0 " + std::to_string(v) + " 1\n";
+    }
+    for (int i = 0; i < 40; ++i) {
+        upload += "Prim\n";      // megabytes of replies
+    }
+    upload += "Removeedge 0 1";    // cut short: "Removeedge 0 17" was on its way
+    for (size_t sent = 0; sent < upload.size();) {
+        ssize_t n = send(stalled, upload.data() + sent, upload.size() - sent, 0);
+        REQUIRE(n > 0);
+        sent += n;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    timeval patience{2, 0};
+    setsockopt(stalled, SOL_SOCKET, SO_RCVTIMEO, &patience, sizeof(patience));
+    size_t drained = 0;
+    ssize_t received;
+    while ((received = recv(stalled, buffer, sizeof(buffer), 0)) > 0) {
+        drained += received;
+    }
+    CHECK((received == 0 || errno == ECONNRESET));
+    CHECK(drained < 40 * 10 * static_cast<size_t>(starVertices));
+    close(stalled);
+    // nothing left in the buffer of a dropped client runs
+    CHECK(graphs.snapshot("star")->getEdges().size() == 2 * static_cast<size_t>(starVertices - 1));
+
+    // the threads stop once the pool has been idle for a second
+    serverThread.join();
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getNumVertices() == 3);
+}
+
+TEST_CASE ("Active object solve pipeline") {
+    // messages run one at a time in the order they were sent
+    std::vector<int> order;
+    {
+        ActiveObject stage("stage");
+        for (int i = 0; i < 100; ++i) {
+            stage.send([&order, i] { order.push_back(i); });
+        }
+    }
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(order == expected);
+
+    GraphRegistry graphs;
+    std::shared_ptr<NamedGraph> named = graphs.find(GraphRegistry::DEFAULT_GRAPH);
+    std::shared_ptr<GraphStore> graph(named, &named->store);
+    graph->update([](Graph& g) {
+        g.resetGraph(4);
+        g.addEdge(0, 1, 4);
+        g.addEdge(1, 2, 2);
+        g.addEdge(2, 3, 7);
+        g.addEdge(0, 3, 1);
+    });
+
+    std::string single;
+    {
+        ClientSession session(graphs);
+        single = session.execute("Boruvka");    // solved and cached outside the pipeline
+    }
+    std::vector<std::string> commands = {"Prim", "Kruskal", "Prim", "Boruvka", "Kruskal"};
+    std::vector<std::promise<std::string>> replies(commands.size());
+    SolvePipeline pipeline;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        std::promise<std::string>* reply = &replies[i];
+        pipeline.submit(commands[i], named, [reply](const std::string& response) { reply->set_value(response); });
+    }
+    std::vector<std::string> responses;
+    for (std::promise<std::string>& reply : replies) {
+        responses.push_back(reply.get_future().get());
+    }
+    CHECK(responses[0].find("Minimum Spanning Tree (Prim):") == 0);
+    CHECK(responses[1].find("Minimum Spanning Tree (Kruskal):") == 0);
+    CHECK(responses[0].find("Total weight: 7") != std::string::npos);
+    CHECK(responses[1].find("Total weight: 7") != std::string::npos);
+    CHECK(responses[2] == responses[0]);
+    CHECK(responses[3] == single);
+    CHECK(responses[4] == responses[1]);
+
+    // a flight led outside the pipeline holds up only its own followers
+    graph->update([](Graph& g) { g.addEdge(1, 3, 3); });
+    unsigned long long generation = graph->snapshot()->getGeneration();
+    ResultCache::Flight outside = named->results->join(generation, MSTFactory::PRIM);
+    REQUIRE(outside.leader);
+    std::promise<std::string> follower, other;
+    pipeline.submit("Prim", named, [&follower](const std::string& response) { follower.set_value(response); });
+    pipeline.submit("Kruskal", named, [&other](const std::string& response) { other.set_value(response); });
+    std::future<std::string> followerReply = follower.get_future();
+    std::future<std::string> otherReply = other.get_future();
+    REQUIRE(otherReply.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CHECK(otherReply.get().find("Total weight: 6") != std::string::npos);
+    CHECK(followerReply.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready);
+    std::shared_ptr<const SolveResult> solved = makeSolveResult({Edge(0, 3, 1), Edge(1, 2, 2), Edge(1, 3, 3)}, MSTFactory::PRIM);
+    named->results->complete(generation, MSTFactory::PRIM, solved);
+    CHECK(followerReply.get() == solved->response);
+
+    std::string stats = pipeline.statsResponse();
+    for (const char* stage : {"parse: ", "solve: ", "metrics: ", "render: ", "wait: "}) {
+        CHECK(stats.find(stage) != std::string::npos);
+    }
+}
+
+TEST_CASE ("Binary wire protocol") {
+    std::string records = encodeEdges({Edge(0, 1, 4), Edge(1, 2, -6), Edge(2, 9, 1)});
+    CHECK(records.size() == 3 * EDGE_RECORD_SIZE);
+    CHECK(readI32(records.data() + EDGE_RECORD_SIZE + 8) == -6);
+
+    std::string graphPayload;
+    putU32(graphPayload, 3);
+    putU32(graphPayload, 3);
+    std::string stream = std::string(PROTOCOL_MAGIC, PROTOCOL_MAGIC_SIZE) + char(2)
+                       + encodeFrame(FRAME_NEW_GRAPH, graphPayload + records) + encodeFrame(FRAME_TEXT, "Prim")
+                       + encodeFrame(FRAME_TEXT, "Newedge 0 2 1") + encodeFrame(7, "");
+    std::string oversized;
+    putU32(oversized, MAX_FRAME_SIZE + 1);
+    stream += oversized + "abc";
+
+    // fed one byte at a time, the frames come out whole
+    CommandFramer framer;
+    std::vector<std::string> frames;
+    std::string command;
+    for (char byte : stream) {
+        framer.feed(&byte, 1);
+        while (framer.nextCommand(command, true)) {
+            frames.push_back(command);
+        }
+    }
+    CHECK(framer.isBinary());
+    REQUIRE(frames.size() == 6);
+    CHECK(frames[0] == std::string(1, char(FRAME_HELLO)) + char(2));
+    CHECK(frames[2] == std::string(1, char(FRAME_TEXT)) + "Prim");
+    CHECK(frames[5] == std::string(1, char(FRAME_TOO_LARGE)));
+    // the rest of the oversized frame is dropped, later frames still line up
+    std::string chunk(1 << 20, 'x');
+    for (size_t left = MAX_FRAME_SIZE - 2; left > 0; left -= std::min(left, chunk.size())) {
+        framer.feed(chunk.data(), std::min(left, chunk.size()));
+    }
+    CHECK(framer.buffered() == 0);
+    std::string next = encodeFrame(FRAME_TEXT, "Bottleneck");
+    framer.feed(next.data(), next.size());
+    CHECK(framer.nextCommand(command, true));
+    CHECK(command == std::string(1, char(FRAME_TEXT)) + "Bottleneck");
+
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    std::vector<std::string> replies;
+    for (const std::string& frame : frames) {
+        replies.push_back(session.executeFrame(frame));
+    }
+    CHECK(replies[0] == encodeFrame(REPLY_OK, std::string(1, char(PROTOCOL_VERSION))));
+    CHECK(replies[1] == encodeFrame(REPLY_OK, "Graph created with 3 vertices and 2 edges.\n"));
+    CHECK(readU32(replies[2].data()) == replies[2].size() - 4);
+    CHECK(replies[2][4] == char(REPLY_OK));
+    CHECK(replies[2].find("Total weight: -2") != std::string::npos);
+    CHECK(replies[3] == encodeFrame(REPLY_OK, ""));
+    CHECK(replies[4][4] == char(REPLY_ERROR));
+    CHECK(replies[5] == encodeFrame(REPLY_ERROR, "Error: Frame too large\n"));
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getEdges().size() == 6);
+
+    // anything else is the text protocol
+    CommandFramer textFramer;
+    textFramer.feed("MS", 2);
+    CHECK_FALSE(textFramer.nextCommand(command, true));
+    textFramer.feed("T\n", 2);
+    CHECK(textFramer.nextCommand(command, true));
+    CHECK_FALSE(textFramer.isBinary());
+    CHECK(command == "MST");
+}
+
+TEST_CASE ("Bulk graph upload") {
+    std::string stream = "Newgraph 4 4 bulk\n0 1 5\n1 2 -3\n2 3 12\n3 0 7\nPrim\n";
+
+    // fed a few bytes at a time, numbers split across segments are not taken early
+    CommandFramer framer;
+    std::vector<std::string> commands;
+    std::string command;
+    for (size_t pos = 0; pos < stream.size(); pos += 3) {
+        std::string segment = stream.substr(pos, 3);
+        framer.feed(segment.data(), segment.size());
+        while (framer.nextCommand(command, false)) {
+            commands.push_back(command);
+        }
+    }
+    REQUIRE(commands.size() == 2);
+    CHECK(commands[0] == "Newgraph 4 4 bulk\n" + encodeEdges({Edge(0, 1, 5), Edge(1, 2, -3), Edge(2, 3, 12), Edge(3, 0, 7)}));
+    CHECK(commands[1] == "Prim");
+
+    // the whole list gets a single acknowledgement
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    CHECK(session.execute(commands[0]) == "Graph created with 4 vertices and 4 edges.\n");
+    // a repeated edge is not counted as added
+    CHECK(session.execute("Newgraph 3 3 bulk\n" + encodeEdges({Edge(0, 1, 5), Edge(1, 0, 6), Edge(1, 2, 7)}))
+          == "Graph created with 3 vertices and 2 edges.\n");
+    CHECK(session.execute(commands[0]) == "Graph created with 4 vertices and 4 edges.\n");
+    CHECK_FALSE(session.expectsEdges());
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getEdges().size() == 8);
+    CHECK(session.execute(commands[1]).find("Total weight: 9") != std::string::npos);
+
+    // the last number may end with the data only once no more is coming
+    CommandFramer tail;
+    tail.feed("Newgraph 2 1 bulk\n0 1 4", 23);
+    CHECK_FALSE(tail.nextCommand(command, false));
+    tail.feed("2", 1);
+    CHECK(tail.nextCommand(command, true));
+    CHECK(command == "Newgraph 2 1 bulk\n" + encodeEdges({Edge(0, 1, 42)}));
+
+    // a malformed number ends the list at its line, the lines after it are commands again
+    CommandFramer malformed;
+    std::string bad = "Newgraph 3 2 bulk\n0 1 x\nMST\n";
+    malformed.feed(bad.data(), bad.size());
+    REQUIRE(malformed.nextCommand(command, true));
+    CHECK(session.execute(command) == "Error: Invalid bulk edge list\n");
+    CHECK(malformed.nextCommand(command, true));
+    CHECK(command == "MST");
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getNumVertices() == 4);
+
+    // more edges than a binary frame holds: refused from the header, before any edge is buffered
+    CommandFramer huge;
+    std::string header = "Newgraph 3 100000000 bulk\n0 1 5\n1 2 6\n";
+    huge.feed(header.data(), header.size());
+    REQUIRE(huge.nextCommand(command, false));
+    CHECK(command == "Newgraph 3 100000000 bulk");
+    CHECK(session.execute(command) == "Error: Bulk graph too large, at most 22369621 edges\n");
+    CHECK_FALSE(huge.nextCommand(command, false));
+    CHECK(huge.buffered() <= 1);               // the numbers are dropped, not kept
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getNumVertices() == 4);
+
+    // many edges at once keep addEdge's rules: no duplicates, ends out of range skipped
+    Graph bulk(3);
+    bulk.addEdge(0, 1, 2);
+    unsigned long long before = bulk.getGeneration();
+    CHECK(bulk.addEdges({Edge(0, 1, 9), Edge(1, 2, 3), Edge(2, 5, 1)}) == 1);
+    CHECK(bulk.getGeneration() > before);
+    CHECK(bulk.getEdges().size() == 4);
+    CHECK(bulk.getEdge(0, 1).weight == 2);
+}
+
+TEST_CASE ("Command tokenizer") {
+    const char* names[] = {"Newgraph", "Newedge", "Removeedge", "Boruvka", "Prim", "Kruskal", "Batch", "Bottleneck",
+                           "Minimax", "Path", "Clusters", "Cut", "Sample", "Stats"};
+    std::set<CommandId> ids;
+    for (const char* name : names) {
+        ids.insert(commandId(name));
+    }
+    CHECK(ids.size() == 14);
+    CHECK(ids.count(CMD_UNKNOWN) == 0);
+    CHECK(commandId("Prim") == CMD_PRIM);
+    CHECK(commandId("Stats") == CMD_STATS);
+    // same slot or same length, but not a command
+    for (const char* other : {"", "prim", "Prim ", "Pxim", "MST", "Cat", "Stat", "Newgrap", "Bottleneckk"}) {
+        CHECK(commandId(other) == CMD_UNKNOWN);
+    }
+
+    int value = 0;
+    CHECK((parseInt("42", value) && value == 42));
+    CHECK((parseInt("-7", value) && value == -7));
+    CHECK((parseInt("+5", value) && value == 5));
+    CHECK((parseInt("2147483647", value) && value == INT_MAX));
+    for (const char* bad : {"", "-", "+", "+-1", "5x", "x5", "2147483648", "1.5"}) {
+        CHECK_FALSE(parseInt(bad, value));
+    }
+
+    std::string text = "Path 2\t0 1\r\n1 3 ";
+    Tokenizer tokens(text);
+    std::string_view token;
+    REQUIRE(tokens.next(token));
+    CHECK(token == "Path");
+    CHECK(token.data() == text.data());
+    int count;
+    CHECK((tokens.nextInt(count) && count == 2));
+    SocketIntReader reader(tokens.rest());
+    std::vector<std::pair<int, int>> pairs;
+    CHECK(readPairs(reader, count, pairs));
+    CHECK(pairs == std::vector<std::pair<int, int>>{{0, 1}, {1, 3}});
+    int remaining = 0;
+    while (tokens.next(token)) {
+        remaining++;
+    }
+    CHECK(remaining == 4);
+
+    // many commands from one segment, then one split across segments
+    CommandFramer framer;
+    std::string segment = "Newedge 0 1 2\nPrim\nRemoveedge 0 1\nKrus";
+    framer.feed(segment.data(), segment.size());
+    std::string command;
+    std::vector<std::string> commands;
+    while (framer.nextCommand(command, false)) {
+        commands.push_back(command);
+    }
+    CHECK(commands == std::vector<std::string>{"Newedge 0 1 2", "Prim", "Removeedge 0 1"});
+    CHECK(framer.buffered() == 4);
+    framer.feed("kal\n", 4);
+    CHECK(framer.nextCommand(command, false));
+    CHECK(command == "Kruskal");
+    CHECK(framer.buffered() == 1);
+}
+
+TEST_CASE ("Pipelined requests") {
+    GraphRegistry sessionGraphs;
+    ClientSession session(sessionGraphs);
+    CHECK(session.mutates("Newedge 0 1 2", false));
+    CHECK(session.mutates("Removeedge 0 1", false));
+    CHECK_FALSE(session.mutates("Prim", false));
+    CHECK_FALSE(session.mutates("Path 1 0 2", false));
+    CHECK(session.mutates(std::string(1, char(FRAME_ADD_EDGES)), true));
+    CHECK_FALSE(session.mutates(std::string(1, char(FRAME_TEXT)) + "Bottleneck", true));
+    session.execute("Newgraph 3 1");
+    CHECK(session.mutates("Prim", false));      // the edge list of the Newgraph
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    REQUIRE(bind(listener, (sockaddr*) &address, sizeof(address)) == 0);
+    REQUIRE(listen(listener, SOMAXCONN) == 0);
+    socklen_t length = sizeof(address);
+    getsockname(listener, (sockaddr*) &address, &length);
+
+    GraphRegistry graphs;
+    std::thread serverThread([&] {
+        Reactor reactor(listener, graphs, 4);
+        reactor.run(1);
+    });
+
+    // everything in one go: the reads between the writes run in parallel, the replies keep the order
+    std::string request = "Newgraph 3 3\n0 1 4\n1 2 2\n0 2 7\nPrim\nBottleneck\n";
+    for (int i = 0; i < 10; ++i) {
+        request += "Path 1 0 2\n";
+    }
+    request += "Removeedge 0 1\nPrim\nPath 1 0 2\nPr";
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(connect(client, (sockaddr*) &address, sizeof(address)) == 0);
+    send(client, request.data(), request.size(), 0);
+    // the rest of a command cut by the segment, a while later
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    send(client, "im\n", 3, 0);
+    shutdown(client, SHUT_WR);
+    std::string reply;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        reply.append(buffer, received);
+    }
+    close(client);
+
+    // a client that pipelines without ever reading its replies: once dispatch is held up the
+    // reactor leaves its input in the socket, so the client's sends block instead of the server
+    // buffering everything
+    int flooder = socket(AF_INET, SOCK_STREAM, 0);
+    int smallBuffer = 4096;
+    setsockopt(flooder, SOL_SOCKET, SO_RCVBUF, &smallBuffer, sizeof(smallBuffer));
+    REQUIRE(connect(flooder, (sockaddr*) &address, sizeof(address)) == 0);
+    std::string commands;
+    while (commands.size() < 65536) {
+        commands += "Prim\n";
+    }
+    const size_t floodLimit = size_t(128) << 20;
+    size_t flooded = 0;
+    while (flooded < floodLimit) {
+        ssize_t n = send(flooder, commands.data(), commands.size(), MSG_DONTWAIT);
+        if (n > 0) {
+            flooded += n;
+            continue;
+        }
+        pollfd writable{flooder, POLLOUT, 0};
+        if (poll(&writable, 1, 500) == 0) {
+            break;      // the server stopped reading
+        }
+    }
+    CHECK(flooded < size_t(64) << 20);
+    close(flooder);
+    serverThread.join();
+
+    CHECK(reply.rfind("Graph created. Send 3 edges (u v weight).\nEdge added. 2 edges remaining.\n", 0) == 0);
+    size_t firstPrim = reply.find("Total weight: 6");
+    size_t bottleneck = reply.find("Bottleneck Spanning Tree:");
+    size_t secondPrim = reply.find("Total weight: 9");
+    REQUIRE(firstPrim != std::string::npos);
+    CHECK(firstPrim < bottleneck);
+    CHECK(bottleneck < secondPrim);
+    size_t pos = bottleneck;
+    for (int i = 0; i < 10; ++i) {
+        pos = reply.find("0 2: distance 6, max edge 4\n", pos + 1);
+        REQUIRE(pos != std::string::npos);
+        CHECK(pos < secondPrim);
+    }
+    REQUIRE(secondPrim != std::string::npos);
+    CHECK(reply.find("0 2: distance 7, max edge 7\n") > secondPrim);
+    CHECK(reply.find("Total weight: 9", secondPrim + 1) != std::string::npos);
+}
+
+TEST_CASE ("Graph snapshots") {
+    GraphStore store(4);
+    GraphSnapshot empty = store.snapshot();
+    CHECK(store.snapshot() == empty);          // nothing changed, the same version
+
+    store.update([](Graph& graph) {
+        graph.addEdge(0, 1, 3);
+        graph.addEdge(1, 2, 5);
+    });
+    GraphSnapshot two = store.snapshot();
+    CHECK(two != empty);
+    CHECK(two->getEdges().size() == 4);
+    CHECK(empty->getEdges().empty());           // a version never changes once published
+    CHECK(two->getGeneration() > empty->getGeneration());
+    store.update([](Graph& graph) {
+        graph.removeEdge(0, 3);                 // not there: a new generation all the same
+    });
+    CHECK(store.snapshot()->getGeneration() > two->getGeneration());
+    store.update([](Graph&) {});
+    CHECK(store.snapshot() == store.snapshot());
+
+    // readers solve on their snapshots while a writer keeps changing the graph; every snapshot is a
+    // whole version: a path 0-1-...-k with k = the number of edges (a forest of the 200 vertices
+    // until the path is complete, so not solve(), which has no tree for it)
+    GraphStore path(200);
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done) {
+                GraphSnapshot graph = path.snapshot();
+                size_t edges = graph->getEdges().size() / 2;
+                std::vector<Edge> mst = ParallelKruskalSolver().spanningForest(*graph);
+                long long weight = 0;
+                for (const Edge& edge : mst) {
+                    weight += edge.weight;
+                }
+                if (mst.size() != edges || weight != static_cast<long long>(edges)) {
+                    torn++;
+                }
+            }
+        });
+    }
+    for (int v = 1; v < 200; ++v) {
+        path.update([v](Graph& graph) {
+            graph.addEdge(v - 1, v, 1);
+        });
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    CHECK(torn == 0);
+    CHECK(path.snapshot()->isConnected());
+}
+
+TEST_CASE ("Named graphs") {
+    GraphRegistry graphs;
+    ClientSession alice(graphs);
+    ClientSession bob(graphs);
+    CHECK(alice.execute("Newgraph roads 3 0 bulk\n") == "Graph created with 3 vertices and 0 edges.\n");
+    alice.execute("Newedge 0 1 5");
+    alice.execute("Newedge 1 2 6");
+    bob.execute("Newgraph 2 1");
+    bob.execute("0 1 9");
+    // each tenant works on its own graph
+    CHECK(alice.execute("Prim").find("Total weight: 11") != std::string::npos);
+    CHECK(bob.execute("Prim").find("Total weight: 9") != std::string::npos);
+    CHECK(graphs.snapshot("roads")->getNumVertices() == 3);
+    CHECK(graphs.snapshot(GraphRegistry::DEFAULT_GRAPH)->getNumVertices() == 2);
+
+    CHECK(bob.execute("Use roads") == "Using graph roads.\n");
+    CHECK(bob.execute("Prim").find("Total weight: 11") != std::string::npos);
+    CHECK(bob.execute("Use nowhere") == "Error: No graph named nowhere\n");
+    CHECK(bob.mutates("Use roads", false));
+    CHECK(bob.mutates("Dropgraph roads", false));
+
+    CHECK(alice.execute("Newgraph 9roads 3 0") == "Error: Invalid graph name\n");
+    CHECK(alice.execute("Dropgraph default") == "Error: The default graph cannot be dropped\n");
+    CHECK(alice.execute("Dropgraph roads") == "Dropped graph roads.\n");
+    CHECK(bob.execute("Prim") == "Error: No graph named roads\n");
+    CHECK(graphs.find("roads") == nullptr);
+    CHECK(graphs.used() == graphs.find(GraphRegistry::DEFAULT_GRAPH)->charged);
+    // created again under the same name, the sessions that used it follow
+    alice.execute("Newgraph roads 2 1");
+    alice.execute("0 1 4");
+    CHECK(bob.execute("Prim").find("Total weight: 4") != std::string::npos);
+
+    // query structures are kept in the caches of their own graph, charged to it
+    CHECK(alice.execute("Path 1 0 1") == "MST paths:\n0 1: distance 4, max edge 4\n");
+    std::shared_ptr<NamedGraph> roads = graphs.find("roads");
+    std::shared_ptr<NamedGraph> fallback = graphs.find(GraphRegistry::DEFAULT_GRAPH);
+    CHECK(roads->cached > 0);
+    CHECK(roads->cached == roads->caches.bytes());
+    CHECK(fallback->cached == 0);
+    CHECK(graphs.used() == roads->charged + roads->cached + fallback->charged);
+    alice.execute("Dropgraph roads");
+    CHECK(roads->caches.bytes() == 0);
+    CHECK(graphs.used() == fallback->charged);
+
+    // quotas: one graph may not grow above its own, changes that would are refused whole
+    GraphRegistry small(Graph::memoryFor(4, 2), DEFAULT_TOTAL_QUOTA, 2);
+    ClientSession tenant(small);
+    CHECK(tenant.execute("Newgraph 4 0").find("Graph created") == 0);
+    CHECK(tenant.execute("Newedge 0 1 1") == "");
+    CHECK(tenant.execute("Newedge 1 2 1") == "");
+    CHECK(tenant.execute("Newedge 2 3 1") == "Error: Graph memory quota exceeded\n");
+    CHECK(small.snapshot(GraphRegistry::DEFAULT_GRAPH)->getEdges().size() == 4);
+    CHECK(tenant.execute("Removeedge 0 1") == "");
+    CHECK(tenant.execute("Newedge 2 3 1") == "");
+    CHECK(tenant.execute("Newgraph 100 0") == "Error: Graph memory quota exceeded\n");
+    CHECK(small.used() == small.snapshot(GraphRegistry::DEFAULT_GRAPH)->memoryUsage());
+    // the data fills the quota: the clusters are still answered, their dendrogram is not kept
+    CHECK(tenant.execute("Clusters 1").find("Clusters: 2\n") != std::string::npos);
+    CHECK(small.find(GraphRegistry::DEFAULT_GRAPH)->cached == 0);
+    CHECK(tenant.execute("Newgraph other 1 0").find("Graph created") == 0);
+    CHECK(tenant.execute("Newgraph third 1 0") == "Error: Too many graphs\n");
+    CHECK(small.size() == 2);
+}
+
+TEST_CASE ("Solve jobs") {
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    session.execute("Newgraph 3 2");
+    session.execute("0 1 2");
+    session.execute("1 2 3");
+    std::string submitted = session.execute("Submit Kruskal");
+    REQUIRE(submitted.find("Job ") == 0);
+    int job = std::stoi(submitted.substr(4));
+    session.execute("Removeedge 1 2");          // the job solves the graph it was submitted on
+    std::string status;
+    for (int i = 0; i < 1000 && status != "Job " + std::to_string(job) + ": done\n"; ++i) {
+        status = session.execute("Status " + std::to_string(job));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(status == "Job " + std::to_string(job) + ": done\n");
+    CHECK(session.execute("Result " + std::to_string(job)).find("Total weight: 5") != std::string::npos);
+    CHECK(session.execute("Submit Cut") == "Error: Unknown algorithm Cut\n");
+    CHECK(session.execute("Result 999999") == "Error: No job 999999\n");
+    CHECK_FALSE(session.mutates("Submit Prim", false));
+
+    // every unfinished job pins a snapshot of its graph: bounded per graph. The shared workers are
+    // held up so the jobs stay queued
+    std::promise<void> go;
+    std::shared_future<void> started = go.get_future().share();
+    for (size_t w = 0; w < DEFAULT_JOB_WORKERS; ++w) {
+        REQUIRE(sharedJobStore().submit([started] { started.wait(); return std::string(); }) != 0);
+    }
+    std::string last;
+    for (size_t j = 0; j < MAX_GRAPH_JOBS; ++j) {
+        session.execute("Newedge 1 2 " + std::to_string(j + 3));   // a new version for every job
+        last = session.execute("Submit Prim");
+        REQUIRE(last.find("Job ") == 0);
+    }
+    CHECK(session.execute("Submit Prim") == "Error: Too many unfinished jobs on graph default\n");
+    CHECK(graphs.find(GraphRegistry::DEFAULT_GRAPH)->jobs == MAX_GRAPH_JOBS);
+    ClientSession other(graphs);
+    other.execute("Newgraph other 2 1");
+    other.execute("0 1 1");
+    CHECK(other.execute("Submit Prim").find("Job ") == 0);
+    go.set_value();
+    std::string lastJob = last.substr(4, last.find(' ', 4) - 4);
+    for (int i = 0; i < 5000 && status != "Job " + lastJob + ": done\n"; ++i) {
+        status = session.execute("Status " + lastJob);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(status == "Job " + lastJob + ": done\n");
+    CHECK(session.execute("Submit Prim").find("Job ") == 0);
+
+    // bounded: finished jobs are evicted least recently polled first, unfinished ones never
+    JobStore jobs(1, 2);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    uint64_t slow = jobs.submit([released] { released.wait(); return std::string("slow\n"); });
+    uint64_t queued = jobs.submit([] { return std::string("queued\n"); });
+    CHECK(jobs.submit([] { return std::string(); }) == 0);
+    release.set_value();
+    JobStore::State state = JobStore::QUEUED;
+    std::string result;
+    while (!jobs.find(queued, state, result) || state != JobStore::DONE) {
+        std::this_thread::yield();
+    }
+    CHECK(result == "queued\n");
+    uint64_t third = jobs.submit([] { return std::string("third\n"); });
+    CHECK(third != 0);
+    CHECK_FALSE(jobs.find(slow, state, result));   // polled longest ago
+    CHECK(jobs.find(queued, state, result));
+
+    // a job that throws something other than an exception fails like any other
+    JobStore throwing(1, 4);
+    uint64_t odd = throwing.submit([]() -> std::string { throw 42; });
+    while (!throwing.find(odd, state, result) || state == JobStore::QUEUED || state == JobStore::RUNNING) {
+        std::this_thread::yield();
+    }
+    CHECK(state == JobStore::FAILED);
+    CHECK(throwing.submit([] { return std::string("after\n"); }) != 0);
+}
+
+TEST_CASE ("Empty graph") {
+    CHECK(Graph(0).isConnected());
+    // a fresh server: every command on the empty default graph answers instead of crashing
+    GraphRegistry graphs;
+    ClientSession session(graphs);
+    std::vector<std::pair<const char*, const char*>> replies = {
+        {"Boruvka", "Minimum Spanning Tree (Boruvka):\n"}, {"Prim", "Minimum Spanning Tree (Prim):\n"},
+        {"Kruskal", "Minimum Spanning Tree (Kruskal):\n"}, {"Bottleneck", "Bottleneck Spanning Tree:\n"},
+        {"Clusters 2", "Single-linkage clustering (k=2):\n"}, {"Cut 5", "Single-linkage clustering (threshold=5):\n"},
+        {"Sample 3", "Distance sample: needs at least 2 vertices"}, {"Path 1 0 0", "MST paths:\n0 0: not connected\n"},
+        {"Minimax 1 0 0", "Minimax path weights:\n0 0: not connected\n"}};
+    for (const std::pair<const char*, const char*>& reply : replies) {
+        CHECK(session.execute(reply.first).rfind(reply.second, 0) == 0);
+    }
+
+    // bulk edges onto a vertex of high degree, with duplicates in the batch and in the graph
+    Graph star(2001);
+    star.addEdge(0, 1, 9);
+    std::vector<Edge> spokes;
+    for (int v = 1; v <= 2000; ++v) {
+        spokes.push_back(Edge(0, v, v));
+        spokes.push_back(Edge(v, 0, v));
+    }
+    star.addEdges(spokes);
+    CHECK(star.getNeighbors(0).size() == 2000);
+    CHECK(star.getEdge(0, 1).weight == 9);      // the edge already there is kept
+    CHECK(star.memoryUsage() == Graph::memoryFor(2001, 2000));
+}
@@ -1,4 +1,7 @@
 #include "ThreadPool.hpp"
+#include <algorithm>
+#include <memory>
+#include <exception>
 
 ThreadPool::ThreadPool(size_t numThreads) : stop(false), activeTasks(0) {
     for (size_t i = 0; i < numThreads; ++i) {
@@ -26,6 +29,51 @@ void ThreadPool::enqueue(std::function<void()> task) {
     }
 }
 
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    // std::function needs a copyable callable, so the packaged_task is shared
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> result = packaged->get_future();
+    enqueue([packaged] { (*packaged)(); });
+    return result;
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t begin, size_t end)>& body) {
+    size_t numChunks = std::min(n, workers.size() + 1);
+    if (numChunks <= 1) {
+        body(0, n);
+        return;
+    }
+    std::vector<std::future<void>> pending;
+    for (size_t c = 0; c + 1 < numChunks; ++c) {
+        size_t begin = c * n / numChunks;
+        size_t end = (c + 1) * n / numChunks;
+        pending.push_back(submit([&body, begin, end] { body(begin, end); }));
+    }
+    // Every chunk refers to body, so wait for all of them even if one throws
+    std::exception_ptr error;
+    try {
+        body((numChunks - 1) * n / numChunks, n);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (std::future<void>& f : pending) {
+        try {
+            f.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
 bool ThreadPool::hasActiveTasks() {
     std::unique_lock<std::mutex> lock(mtx);
     return !tasks.empty() || activeTasks > 0;
@@ -44,4 +92,9 @@ void ThreadPool::workerThread() {
         task();
         activeTasks--;
     }
-}
\ No newline at end of file
+}
+
+ThreadPool& computePool() {
+    static ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+    return pool;
+}
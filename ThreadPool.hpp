@@ -9,6 +9,7 @@
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <future>
 
 class ThreadPool {
 public:
@@ -17,6 +18,15 @@ public:
     void enqueue(std::function<void()> task);
     bool hasActiveTasks(); 
 
+    // Enqueue a task and get a future that becomes ready (or holds the exception) when it is done
+    std::future<void> submit(std::function<void()> task);
+
+    // Split [0, n) into one contiguous range per worker, run them on the pool and wait for all.
+    // The calling thread runs the last range itself. Must not be called from inside a pool task.
+    void parallelFor(size_t n, const std::function<void(size_t begin, size_t end)>& body);
+
+    size_t size() const;
+
 private:
     void workerThread();
     std::vector<std::thread> workers;
@@ -27,4 +37,9 @@ private:
     std::atomic<int> activeTasks; // Track active tasks
 };
 
+// Shared pool for data-parallel work inside the solvers, one thread per core.
+// Kept apart from the servers' client pools, so a solver waiting on its chunks is never
+// starved by workers parked in a blocking recv.
+ThreadPool& computePool();
+
 #endif // THREAD_POOL_HPP
@@ -1,10 +1,6 @@
 #include <iostream>
-#include <sstream>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <unordered_map>
-#include <vector>
 #include <string>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -12,8 +8,8 @@
 #include <arpa/inet.h>
 #include <cstring>
 #include <cerrno>
-#include "Graph.hpp"
-#include "MSTFactory.hpp"
+#include "GraphRegistry.hpp"
+#include "ServerSession.hpp"
 #include "ThreadPool.hpp"
 
 using namespace std;        // TODO make it more specific later
@@ -22,127 +18,36 @@ using namespace std;        // TODO make it more specific later
 #define PORT 9034
 #define MAXCONNECTIONS 10
 #define TIMEOUT_SEC 3
-std::mutex graphMutex;
-Graph graph(0);
+GraphRegistry graphs;
 
 // ---------------------------- Declare Functions ----------------------------
-void handle_client_command(int client_socket, const std::string& command);
 void handle_client(int client_socket); 
-void handle_solver(int client_socket, MSTFactory::MSTType type);
 
 // ---------------------------- Functions ----------------------------
-void handle_solver(int client_socket, MSTFactory::MSTType type) {
-    // Solve MST
-    std::unique_ptr<MSTSolver> solver = MSTFactory::createSolver(type);
-    std::vector<Edge> mst = solver->solve(graph);
-
-    // Send results to client
-    std::string response = "Minimum Spanning Tree:\n";
-    for (const Edge& edge : mst) {
-        response += std::to_string(edge.u) + " -> " + std::to_string(edge.v) + " (" + std::to_string(edge.weight) + ")\n";
-    }
-    response += solver->printMetrics(mst);
-    send(client_socket, response.c_str(), response.size(), 0);
-}
-
+// One pool thread per connection, blocking on it the whole time. Framing and commands are the
+// same as in the reactor server (ServerSession), only the socket handling differs
 void handle_client(int client_socket) {
-    char buffer[1024];
+    char buffer[4096];
     int bytesReceived;
-    int expected_edges = 0;
-
-    while ((bytesReceived = recv(client_socket, buffer, 1024, 0)) > 0) {
-        std::istringstream iss(std::string(buffer, bytesReceived));
-        std::string cmd;
-        iss >> cmd;
-
-        std::unique_lock<std::mutex> lock(graphMutex);
-
-        bool validCommand = false;
-
-        if (cmd == "Newgraph") {
-            validCommand = true;
-            int vertices, edges;
-            if (iss >> vertices >> edges) {
-                graph.resetGraph(vertices);
-                std::cout << "Graph created with " << vertices << " vertices. Waiting for " << edges << " edges.\n";
-                std::string response = "Graph created. Send " + std::to_string(edges) + " edges (u v weight).\n";
-                send(client_socket, response.c_str(), response.size(), 0);
-                expected_edges = edges;
-            } else {
-                std::cout << "Error: Invalid graph command format\n";
-            }
-        }
-        
-        while (expected_edges > 0) {
-            cout << "Waiting for " << expected_edges << " edges...\n";
-            bytesReceived = recv(client_socket, buffer, 1024, 0);
-            if (bytesReceived <= 0) {
-                std::cout << "Client disconnected.\n";
-                close(client_socket);
-                return;       // end client thread
-            }
-            std::istringstream iss(std::string(buffer, bytesReceived));
-            int u, v, weight;
-            iss >> u >> v >> weight;
-            if (expected_edges <= 0) {
-                break;
-            }
-            if (u >= 0 && v >= 0 && u < graph.getNumVertices() && v < graph.getNumVertices()) {
-                graph.addEdge(u, v, weight);
-                expected_edges--;
-                std::cout << "Added edge " << u << "->" << v << " [" << weight << "]. " << expected_edges << " edges remaining.\n";
-                std::string response = "Edge added. " + std::to_string(expected_edges) + " edges remaining.\n";
-                send(client_socket, response.c_str(), response.size(), 0);
-            } else {
-                std::cout << "Error: Vertex index out of bounds\n";
+    CommandFramer framer;
+    ClientSession session(graphs);
+
+    while ((bytesReceived = recv(client_socket, buffer, sizeof(buffer), 0)) > 0) {
+        framer.feed(buffer, bytesReceived);
+        // a partial command stays buffered until the rest of it arrives
+        std::string command;
+        while (framer.nextCommand(command, false)) {
+            std::string response = framer.isBinary() ? session.executeFrame(command) : session.execute(command);
+            if (!response.empty()) {
+                send(client_socket, response.c_str(), response.size(), MSG_NOSIGNAL);
             }
+            std::cout << std::endl;
         }
-        lock.unlock();
-        
-        if (cmd == "Newedge") {
-            validCommand = true;
-            int u, v, weight;
-            if (iss >> u >> v >> weight) {
-                if (u >= 0 && v >= 0 && u < graph.getNumVertices() && v < graph.getNumVertices()) {
-                    lock.lock();
-                    graph.addEdge(u, v, weight);
-                    lock.unlock();
-                    std::cout << "Added edge " << u << "->" << v << " [" << weight << "].\n";
-                } else {
-                    std::cout << "Error: Vertex index out of bounds\n";
-                }
-            } else {
-                std::cout << "Error: Invalid edge command format\n";
-            }
-        }
-        else if (cmd == "Removeedge") {
-            validCommand = true;
-            int u, v;
-            if (iss >> u >> v) {
-                if (u >= 0 && v >= 0 && u < graph.getNumVertices() && v < graph.getNumVertices()) {
-                    lock.lock();
-                    graph.removeEdge(u, v);
-                    lock.unlock();
-                    std::cout << "Removed edge from " << u << " to " << v << ".\n";
-                } else {
-                    std::cout << "Error: Vertex index out of bounds\n";
-                }
-            } else {
-                std::cout << "Error: Invalid edge command format\n";
-            }
-        }
-        else if (cmd == "Boruvka") {
-            validCommand = true;
-            handle_solver(client_socket, MSTFactory::BORUVKA);
-        }
-        else if (cmd == "Prim") {
-            validCommand = true;
-            handle_solver(client_socket, MSTFactory::BORUVKA);
-        }
-        else if (!validCommand) {
-            std::cout << "Unknown command.\n";
-        }
-        std::cout << std::endl;
+    }
+    // commands the client sent right before hanging up still run, nobody reads their replies
+    std::string command;
+    while (framer.nextCommand(command, true)) {
+        framer.isBinary() ? session.executeFrame(command) : session.execute(command);
     }
     std::cout << "Client disconnected.\n";
     close(client_socket);
@@ -0,0 +1,246 @@
+#include "TreeMetrics.hpp"
+#include <algorithm>
+#include <climits>
+#include <thread>
+
+TreeAdjacency::TreeAdjacency(const std::vector<Edge>& edges) {
+    num_vertices = 0;
+    for (const Edge& edge : edges) {
+        num_vertices = std::max(num_vertices, std::max(edge.u, edge.v) + 1);
+    }
+    start.assign(num_vertices + 1, 0);
+    for (const Edge& edge : edges) {
+        start[edge.u + 1]++;
+        start[edge.v + 1]++;
+    }
+    for (int v = 0; v < num_vertices; ++v) {
+        start[v + 1] += start[v];
+    }
+    neighbor.resize(start[num_vertices]);
+    weight.resize(start[num_vertices]);
+    std::vector<int> fillPos(start.begin(), start.end() - 1);
+    for (const Edge& edge : edges) {
+        neighbor[fillPos[edge.u]] = edge.v;
+        weight[fillPos[edge.u]++] = edge.weight;
+        neighbor[fillPos[edge.v]] = edge.u;
+        weight[fillPos[edge.v]++] = edge.weight;
+    }
+}
+
+std::vector<long long> treeDistances(const TreeAdjacency& tree, int source) {
+    std::vector<long long> distance(tree.num_vertices, -1);
+    std::vector<char> visited(tree.num_vertices, 0);
+    std::vector<int> queue;
+    queue.reserve(tree.num_vertices);
+    distance[source] = 0;
+    visited[source] = 1;
+    queue.push_back(source);
+    // In a tree every vertex is reached by exactly one path, so BFS order gives weighted distances
+    // (-1 is a real distance with negative weights, hence the separate visited flags)
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        for (int i = tree.start[u]; i < tree.start[u + 1]; ++i) {
+            int v = tree.neighbor[i];
+            if (!visited[v]) {
+                visited[v] = 1;
+                distance[v] = distance[u] + tree.weight[i];
+                queue.push_back(v);
+            }
+        }
+    }
+    return distance;
+}
+
+// Index of the largest distance
+static int farthest(const std::vector<long long>& distance) {
+    int best = 0;
+    for (int v = 1; v < static_cast<int>(distance.size()); ++v) {
+        if (distance[v] > distance[best]) {
+            best = v;
+        }
+    }
+    return best;
+}
+
+long long treeDiameter(const TreeAdjacency& tree) {
+    if (tree.num_vertices == 0) {
+        return 0;
+    }
+    int end = farthest(treeDistances(tree, 0));
+    std::vector<long long> fromEnd = treeDistances(tree, end);
+    return fromEnd[farthest(fromEnd)];
+}
+
+long long pairwiseDistanceSum(const TreeAdjacency& tree) {
+    int n = tree.num_vertices;
+    if (n == 0) {
+        return 0;
+    }
+
+    // BFS order from vertex 0, then subtree sizes bottom-up in reverse order
+    std::vector<int> order;
+    std::vector<int> parent(n, -1);
+    std::vector<int> parentWeight(n, 0);
+    std::vector<char> visited(n, 0);
+    order.reserve(n);
+    order.push_back(0);
+    visited[0] = 1;
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        for (int i = tree.start[u]; i < tree.start[u + 1]; ++i) {
+            int v = tree.neighbor[i];
+            if (!visited[v]) {
+                visited[v] = 1;
+                parent[v] = u;
+                parentWeight[v] = tree.weight[i];
+                order.push_back(v);
+            }
+        }
+    }
+
+    std::vector<long long> subtreeSize(n, 1);
+    long long total = 0;
+    long long reached = static_cast<long long>(order.size());
+    for (size_t i = order.size(); i-- > 1;) {
+        int v = order[i];
+        total += parentWeight[v] * subtreeSize[v] * (reached - subtreeSize[v]);
+        subtreeSize[parent[v]] += subtreeSize[v];
+    }
+    return total;
+}
+
+MetricsResult computeMetrics(const std::vector<Edge>& tree, size_t minParallelSize) {
+    MetricsResult metrics;
+    if (tree.empty()) {
+        return metrics;
+    }
+    // the parallel passes do about twice the work of this one, so they need a few cores to pay off
+    if (tree.size() >= minParallelSize && std::thread::hardware_concurrency() >= 4) {
+        return computeMetricsParallel(tree);
+    }
+
+    // Pass over the edges: weights, plus the CSR adjacency (which also gives the degrees)
+    TreeAdjacency adjacency(tree);
+    int n = adjacency.num_vertices;
+    metrics.numVertices = n;
+    metrics.numEdges = static_cast<int>(tree.size());
+    metrics.minEdgeWeight = INT_MAX;
+    metrics.maxEdgeWeight = INT_MIN;
+    for (const Edge& edge : tree) {
+        metrics.totalWeight += edge.weight;
+        metrics.minEdgeWeight = std::min(metrics.minEdgeWeight, edge.weight);
+        metrics.maxEdgeWeight = std::max(metrics.maxEdgeWeight, edge.weight);
+        metrics.weightHistogram.record(edge.weight);
+    }
+
+    // BFS from vertex 0, degrees on the way
+    std::vector<int> order;
+    std::vector<int> parent(n, -1);
+    std::vector<int> parentWeight(n, 0);
+    std::vector<char> visited(n, 0);
+    order.reserve(n);
+    order.push_back(0);
+    visited[0] = 1;
+    metrics.minDegree = INT_MAX;
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        int degree = adjacency.start[u + 1] - adjacency.start[u];
+        metrics.minDegree = std::min(metrics.minDegree, degree);
+        metrics.maxDegree = std::max(metrics.maxDegree, degree);
+        metrics.numLeaves += degree == 1;
+        for (int i = adjacency.start[u]; i < adjacency.start[u + 1]; ++i) {
+            int v = adjacency.neighbor[i];
+            if (!visited[v]) {
+                visited[v] = 1;
+                parent[v] = u;
+                parentWeight[v] = adjacency.weight[i];
+                order.push_back(v);
+            }
+        }
+    }
+    long long reached = static_cast<long long>(order.size());
+    metrics.averageDegree = 2.0 * metrics.numEdges / reached;
+
+    // Bottom-up: subtree sizes and the two longest downward paths of every vertex (through different
+    // children). The diameter is the best sum of the two longest downward paths through a vertex
+    // (negative branches are never taken).
+    std::vector<long long> subtreeSize(n, 1);
+    std::vector<long long> down(n, 0);
+    std::vector<long long> secondDown(n, 0);
+    std::vector<int> downChild(n, -1);
+    for (size_t i = order.size(); i-- > 1;) {
+        int v = order[i];
+        int p = parent[v];
+        long long w = parentWeight[v];
+        metrics.pairwiseDistanceSum += w * subtreeSize[v] * (reached - subtreeSize[v]);
+        subtreeSize[p] += subtreeSize[v];
+
+        long long branch = down[v] + w;
+        metrics.diameter = std::max(metrics.diameter, down[p] + branch);
+        if (branch > down[p]) {
+            secondDown[p] = down[p];
+            down[p] = branch;
+            downChild[p] = v;
+        } else {
+            secondDown[p] = std::max(secondDown[p], branch);
+        }
+    }
+
+    // Top-down rerooting: the longest path leaving v through its parent either continues upwards
+    // or goes down into a sibling, i.e. the parent's best branch that does not start with v
+    std::vector<long long> eccentricity(n, 0);
+    std::vector<long long> up(n, 0);
+    eccentricity[0] = down[0];
+    metrics.radius = down[0];
+    for (size_t i = 1; i < order.size(); ++i) {
+        int v = order[i];
+        int p = parent[v];
+        long long sibling = downChild[p] == v ? secondDown[p] : down[p];
+        up[v] = parentWeight[v] + std::max(up[p], sibling);
+        eccentricity[v] = std::max(down[v], up[v]);
+        metrics.radius = std::min(metrics.radius, eccentricity[v]);
+    }
+    metrics.eccentricityHistogram.assign(ECCENTRICITY_BUCKETS, 0);
+    for (int v : order) {
+        metrics.eccentricityHistogram[eccentricityBucket(eccentricity[v], metrics.radius, metrics.diameter)]++;
+        if (eccentricity[v] == metrics.radius) {
+            metrics.centers.push_back(v);
+        }
+    }
+    std::sort(metrics.centers.begin(), metrics.centers.end());
+
+    long long numPairs = reached * (reached + 1) / 2;
+    metrics.averageDistance = static_cast<double>(metrics.pairwiseDistanceSum) / numPairs;
+    return metrics;
+}
+
+int eccentricityBucket(long long eccentricity, long long radius, long long diameter) {
+    return static_cast<int>((eccentricity - radius) * ECCENTRICITY_BUCKETS / (diameter - radius + 1));
+}
+
+std::string printMetrics(const MetricsResult& metrics) {
+    std::string response = "Metrics:\n";
+    response += "Total weight: " + std::to_string(metrics.totalWeight) + "\n";
+    response += "Longest distance: " + std::to_string(metrics.diameter) + "\n";
+    response += "Shortest distance: " + std::to_string(metrics.minEdgeWeight) + "\n";
+    response += "Average distance: " + std::to_string(metrics.averageDistance) + "\n";
+    response += "Heaviest edge: " + std::to_string(metrics.maxEdgeWeight) + "\n";
+    response += "Edge weight quantiles:";
+    for (int percent : {25, 50, 75, 90, 99}) {
+        response += " p" + std::to_string(percent) + " " + std::to_string(metrics.weightHistogram.quantile(percent / 100.0));
+    }
+    response += "\n";
+    response += "Degree: min " + std::to_string(metrics.minDegree) + ", max " + std::to_string(metrics.maxDegree)
+        + ", average " + std::to_string(metrics.averageDegree) + ", leaves " + std::to_string(metrics.numLeaves) + "\n";
+    response += "Radius: " + std::to_string(metrics.radius) + "\n";
+    response += metrics.centers.size() == 1 ? "Center:" : "Centers:";
+    for (int center : metrics.centers) {
+        response += " " + std::to_string(center);
+    }
+    response += "\nEccentricity histogram (" + std::to_string(ECCENTRICITY_BUCKETS) + " buckets from radius to longest distance):";
+    for (int count : metrics.eccentricityHistogram) {
+        response += " " + std::to_string(count);
+    }
+    response += "\n";
+    return response;
+}
@@ -0,0 +1,77 @@
+#ifndef TREE_METRICS_HPP
+#define TREE_METRICS_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Graph.hpp"
+#include "ThreadPool.hpp"
+#include "WeightHistogram.hpp"
+
+// Adjacency of a tree (or forest) given by its edge list, in CSR form.
+// Vertex ids are 0..max id used by an edge.
+struct TreeAdjacency {
+    int num_vertices;
+    std::vector<int> start;         // neighbors of v are at [start[v], start[v + 1])
+    std::vector<int> neighbor;
+    std::vector<int> weight;
+
+    TreeAdjacency(const std::vector<Edge>& edges);
+};
+
+// Number of equal-width eccentricity buckets between the radius and the diameter
+const int ECCENTRICITY_BUCKETS = 10;
+
+// All MST metrics, produced together by computeMetrics()
+struct MetricsResult {
+    int numVertices = 0;
+    int numEdges = 0;
+    long long totalWeight = 0;
+    int minEdgeWeight = 0;          // also the shortest distance between two different vertices
+    int maxEdgeWeight = 0;
+    long long diameter = 0;         // longest distance between two vertices
+    long long pairwiseDistanceSum = 0;
+    double averageDistance = 0;     // over all pairs (i, j) with j >= i, distance (x, x) = 0
+    int minDegree = 0;
+    int maxDegree = 0;
+    double averageDegree = 0;
+    int numLeaves = 0;
+    long long radius = 0;           // smallest eccentricity (distance from a vertex to the farthest one)
+    std::vector<int> centers;       // vertices whose eccentricity is the radius, ascending
+    std::vector<int> eccentricityHistogram;    // vertices per bucket, see eccentricityBucket()
+    WeightHistogram weightHistogram;           // edge weights, for approximate quantiles
+};
+
+// Every metric of a tree in one fused traversal: one pass over the edges (weights and their
+// histogram, degrees, CSR),
+// one BFS, one bottom-up pass that accumulates subtree sizes (for the pairwise distance sum)
+// and the two longest downward paths (for the diameter) at the same time, and one top-down
+// rerooting pass for the longest upward paths, which gives the eccentricity of every vertex.
+// Trees with at least minParallelSize edges go to computeMetricsParallel() on the compute pool
+// (on machines with 4 or more cores).
+MetricsResult computeMetrics(const std::vector<Edge>& tree, size_t minParallelSize = 1 << 16);
+
+// Same result, computed on the pool with Euler tour list ranking (see ParallelTreeMetrics.cpp).
+// Inputs that are not a single tree fall back to the sequential pass.
+// Must not be called from inside a task of the same pool.
+MetricsResult computeMetricsParallel(const std::vector<Edge>& tree, ThreadPool& pool = computePool());
+
+// Bucket (0 .. ECCENTRICITY_BUCKETS - 1) of an eccentricity in [radius, diameter]:
+// the diameter - radius + 1 possible values split into equal ranges
+int eccentricityBucket(long long eccentricity, long long radius, long long diameter);
+
+// Text block sent to the clients
+std::string printMetrics(const MetricsResult& metrics);
+
+// Weighted diameter (longest distance between two vertices) with two BFS passes: the farthest
+// vertex from any vertex is an end of a diameter, the farthest vertex from that one is the other end.
+long long treeDiameter(const TreeAdjacency& tree);
+
+// Sum of the distances between all vertex pairs (Wiener index) in O(V): removing an edge splits
+// the tree into s and n - s vertices, and exactly s * (n - s) paths use that edge.
+long long pairwiseDistanceSum(const TreeAdjacency& tree);
+
+// Distances from source to every vertex of its tree, -1 for the others (iterative BFS)
+std::vector<long long> treeDistances(const TreeAdjacency& tree, int source);
+
+#endif // TREE_METRICS_HPP
@@ -0,0 +1,116 @@
+#include "TreePathIndex.hpp"
+#include "TreeMetrics.hpp"
+#include <algorithm>
+#include <climits>
+
+TreePathIndex::TreePathIndex(int num_vertices, const std::vector<Edge>& tree) : num_vertices(num_vertices) {
+    TreeAdjacency adjacency(tree);
+    std::vector<int> parent(num_vertices, -1);
+    std::vector<int> parentWeight(num_vertices, INT_MIN);
+    std::vector<int> depth(num_vertices, 0);
+    std::vector<char> visited(num_vertices, 0);
+    rootDistance.assign(num_vertices, 0);
+
+    // Root every tree of the forest at its smallest vertex, BFS keeps it iterative
+    std::vector<int> queue;
+    queue.reserve(num_vertices);
+    for (int r = 0; r < num_vertices; ++r) {
+        if (visited[r]) {
+            continue;
+        }
+        visited[r] = 1;
+        queue.clear();
+        queue.push_back(r);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            if (u >= adjacency.num_vertices) {
+                continue;   // isolated vertex, no edge mentions it
+            }
+            for (int i = adjacency.start[u]; i < adjacency.start[u + 1]; ++i) {
+                int v = adjacency.neighbor[i];
+                if (v < num_vertices && !visited[v]) {
+                    visited[v] = 1;
+                    parent[v] = u;
+                    parentWeight[v] = adjacency.weight[i];
+                    depth[v] = depth[u] + 1;
+                    rootDistance[v] = rootDistance[u] + adjacency.weight[i];
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+
+    lcaIndex = LCAIndex(parent);
+
+    // Binary lifting tables
+    int levels = 1;
+    while ((1 << levels) < num_vertices) {
+        levels++;
+    }
+    up.assign(levels, std::vector<int>(num_vertices));
+    upMax.assign(levels, std::vector<int>(num_vertices));
+    for (int v = 0; v < num_vertices; ++v) {
+        up[0][v] = parent[v] == -1 ? v : parent[v];
+        upMax[0][v] = parentWeight[v];
+    }
+    for (int k = 1; k < levels; ++k) {
+        for (int v = 0; v < num_vertices; ++v) {
+            int middle = up[k - 1][v];
+            up[k][v] = up[k - 1][middle];
+            upMax[k][v] = std::max(upMax[k - 1][v], upMax[k - 1][middle]);
+        }
+    }
+}
+
+bool TreePathIndex::distance(int u, int v, long long& result) const {
+    if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
+        return false;
+    }
+    int ancestor = lcaIndex.lca(u, v);
+    if (ancestor == -1) {
+        return false;
+    }
+    result = rootDistance[u] + rootDistance[v] - 2 * rootDistance[ancestor];
+    return true;
+}
+
+bool TreePathIndex::pathMax(int u, int v, int& result) const {
+    if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices) {
+        return false;
+    }
+    int ancestor = lcaIndex.lca(u, v);
+    if (ancestor == -1) {
+        return false;
+    }
+    if (u == v) {
+        result = 0;
+        return true;
+    }
+
+    // Lift both ends up to the LCA, keeping the heaviest edge seen
+    int heaviest = INT_MIN;
+    int targetDepth = lcaIndex.getDepth(ancestor);
+    for (int end : {u, v}) {
+        int steps = lcaIndex.getDepth(end) - targetDepth;
+        for (int k = 0; steps > 0; ++k, steps >>= 1) {
+            if (steps & 1) {
+                heaviest = std::max(heaviest, upMax[k][end]);
+                end = up[k][end];
+            }
+        }
+    }
+    result = heaviest;
+    return true;
+}
+
+int TreePathIndex::getNumVertices() const {
+    return num_vertices;
+}
+
+size_t TreePathIndex::memoryUsage() const {
+    size_t bytes = sizeof(TreePathIndex) - sizeof(LCAIndex) + lcaIndex.memoryUsage() + rootDistance.capacity() * sizeof(long long);
+    for (size_t k = 0; k < up.size(); ++k) {
+        bytes += 2 * sizeof(up[k]) + (up[k].capacity() + upMax[k].capacity()) * sizeof(int);
+    }
+    return bytes;
+}
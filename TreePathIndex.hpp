@@ -0,0 +1,33 @@
+#ifndef TREE_PATH_INDEX_HPP
+#define TREE_PATH_INDEX_HPP
+
+#include <vector>
+#include "Graph.hpp"
+#include "LCAIndex.hpp"
+
+// Point-to-point queries on a solved MST, built once per tree in O(V log V):
+//  - distance(u, v) in O(1): Euler tour + sparse table LCA and prefix distances from the root
+//  - pathMax(u, v) in O(log V): binary lifting tables holding the heaviest edge of every 2^k jump
+class TreePathIndex {
+private:
+    int num_vertices;
+    std::vector<long long> rootDistance;        // weighted distance from the root of the vertex's tree
+    std::vector<std::vector<int>> up;           // up[k][v] = 2^k-th ancestor of v (the root stays on itself)
+    std::vector<std::vector<int>> upMax;        // heaviest edge on that jump
+    LCAIndex lcaIndex;
+
+public:
+    // MST (or spanning forest) of a graph with num_vertices vertices
+    TreePathIndex(int num_vertices, const std::vector<Edge>& tree);
+
+    // Both return false if u and v are not in the same tree (or out of range)
+    bool distance(int u, int v, long long& result) const;
+    // Heaviest edge on the tree path, 0 for u == v
+    bool pathMax(int u, int v, int& result) const;
+
+    int getNumVertices() const;
+    // Estimated heap and object size, for memory quotas
+    size_t memoryUsage() const;
+};
+
+#endif // TREE_PATH_INDEX_HPP
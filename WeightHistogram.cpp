@@ -0,0 +1,87 @@
+#include "WeightHistogram.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+// Magnitudes go up to 2^31, so the highest power of two range starts at 2^31
+static const int NUM_BUCKETS = WeightHistogram::SUB_BUCKETS * (32 - WeightHistogram::SUB_BUCKET_BITS + 1);
+
+WeightHistogram::WeightHistogram()
+    : positive(NUM_BUCKETS, 0), negative(NUM_BUCKETS, 0), total(0), minWeight(INT_MAX), maxWeight(INT_MIN) {}
+
+int WeightHistogram::bucketOf(unsigned int magnitude) {
+    if (magnitude < SUB_BUCKETS) {
+        return magnitude;
+    }
+    int exponent = 31 - __builtin_clz(magnitude);
+    int shift = exponent - SUB_BUCKET_BITS;
+    int subBucket = (magnitude >> shift) - SUB_BUCKETS;
+    return SUB_BUCKETS * (shift + 1) + subBucket;
+}
+
+long long WeightHistogram::bucketStart(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    long long subBucket = bucket % SUB_BUCKETS;
+    return (SUB_BUCKETS + subBucket) << shift;
+}
+
+long long WeightHistogram::bucketMiddle(int bucket) const {
+    return (bucketStart(bucket) + bucketStart(bucket + 1) - 1) / 2;
+}
+
+void WeightHistogram::record(int weight) {
+    if (weight >= 0) {
+        positive[bucketOf(weight)]++;
+    } else {
+        // -weight overflows for INT_MIN, the unsigned negation does not
+        negative[bucketOf(0u - static_cast<unsigned int>(weight))]++;
+    }
+    total++;
+    minWeight = std::min(minWeight, weight);
+    maxWeight = std::max(maxWeight, weight);
+}
+
+void WeightHistogram::merge(const WeightHistogram& other) {
+    for (int b = 0; b < NUM_BUCKETS; ++b) {
+        positive[b] += other.positive[b];
+        negative[b] += other.negative[b];
+    }
+    total += other.total;
+    minWeight = std::min(minWeight, other.minWeight);
+    maxWeight = std::max(maxWeight, other.maxWeight);
+}
+
+long long WeightHistogram::count() const {
+    return total;
+}
+
+int WeightHistogram::quantile(double q) const {
+    if (total == 0) {
+        return 0;
+    }
+    long long rank = static_cast<long long>(std::ceil(q * total));
+    rank = std::max(1LL, std::min(rank, total));
+
+    // ascending order: negative buckets from the largest magnitude down, then the positive ones
+    long long seen = 0;
+    long long value = maxWeight;
+    bool found = false;
+    for (int b = NUM_BUCKETS - 1; b >= 0 && !found; --b) {
+        seen += negative[b];
+        if (seen >= rank) {
+            value = -bucketMiddle(b);
+            found = true;
+        }
+    }
+    for (int b = 0; b < NUM_BUCKETS && !found; ++b) {
+        seen += positive[b];
+        if (seen >= rank) {
+            value = bucketMiddle(b);
+            found = true;
+        }
+    }
+    return static_cast<int>(std::max<long long>(minWeight, std::min<long long>(value, maxWeight)));
+}
@@ -0,0 +1,38 @@
+#ifndef WEIGHT_HISTOGRAM_HPP
+#define WEIGHT_HISTOGRAM_HPP
+
+#include <vector>
+
+// Streaming histogram of edge weights with log-spaced buckets (HDR histogram layout):
+// magnitudes below SUB_BUCKETS get a bucket each, every larger power of two range [2^e, 2^(e+1))
+// is split into SUB_BUCKETS equal sub-buckets. Recording is O(1) with no allocation, two histograms
+// merge by adding counts, and a quantile is off by less than 1 / SUB_BUCKETS of its value
+// (exact for small weights). Negative weights use a mirrored set of buckets.
+class WeightHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    WeightHistogram();
+
+    void record(int weight);
+    void merge(const WeightHistogram& other);
+
+    long long count() const;
+    // Nearest-rank quantile for q in [0, 1]: the middle of the bucket holding it, kept within
+    // [min, max] of the recorded weights. 0 if nothing was recorded
+    int quantile(double q) const;
+
+private:
+    static int bucketOf(unsigned int magnitude);
+    static long long bucketStart(int bucket);
+    long long bucketMiddle(int bucket) const;
+
+    std::vector<long long> positive;    // weights >= 0, by magnitude bucket
+    std::vector<long long> negative;    // weights < 0, by magnitude bucket
+    long long total;
+    int minWeight;
+    int maxWeight;
+};
+
+#endif // WEIGHT_HISTOGRAM_HPP
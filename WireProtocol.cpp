@@ -0,0 +1,52 @@
+#include "WireProtocol.hpp"
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+uint32_t readU32(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 | static_cast<uint32_t>(bytes[2]) << 16
+         | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+int32_t readI32(const char* data) {
+    return static_cast<int32_t>(readU32(data));
+}
+
+std::string encodeFrame(uint8_t type, const std::string& payload) {
+    std::string frame;
+    frame.reserve(5 + payload.size());
+    putU32(frame, static_cast<uint32_t>(payload.size() + 1));
+    frame.push_back(static_cast<char>(type));
+    frame += payload;
+    return frame;
+}
+
+std::string encodeEdges(const std::vector<Edge>& edges) {
+    std::string records;
+    records.reserve(edges.size() * EDGE_RECORD_SIZE);
+    for (const Edge& edge : edges) {
+        putU32(records, static_cast<uint32_t>(edge.u));
+        putU32(records, static_cast<uint32_t>(edge.v));
+        putU32(records, static_cast<uint32_t>(edge.weight));
+    }
+    return records;
+}
+
+uint32_t addEdgeRecords(Graph& graph, const char* data, uint32_t count) {
+    std::vector<Edge> edges;
+    edges.reserve(count);
+    int numVertices = graph.getNumVertices();
+    for (uint32_t i = 0; i < count; ++i, data += EDGE_RECORD_SIZE) {
+        int u = readI32(data);
+        int v = readI32(data + 4);
+        if (u >= 0 && v >= 0 && u < numVertices && v < numVertices) {
+            edges.push_back(Edge(u, v, readI32(data + 8)));
+        }
+    }
+    // duplicates of each other or of edges already there are not added
+    return static_cast<uint32_t>(graph.addEdges(edges));
+}
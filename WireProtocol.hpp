@@ -0,0 +1,54 @@
+#ifndef WIRE_PROTOCOL_HPP
+#define WIRE_PROTOCOL_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.hpp"
+
+// Binary protocol, next to the text protocol for humans. A client picks it by sending the magic
+// bytes "MSTB" and a version byte as the very first bytes of the connection (no text command
+// starts with them). The server answers with a reply frame holding the version it will speak.
+//
+// Every message afterwards is a frame: u32 length, then length bytes - a type byte and the payload.
+// All integers are little endian. Requests:
+//   FRAME_TEXT       a text command, the same as in the text protocol
+//   FRAME_NEW_GRAPH  u32 V, u32 E, then E edge records: replaces the graph in one go
+//   FRAME_ADD_EDGES  u32 count, then count edge records: adds edges to the graph
+// An edge record is i32 u, i32 v, i32 weight (EDGE_RECORD_SIZE bytes). Every request frame gets
+// exactly one reply frame, in order: a status byte (REPLY_OK / REPLY_ERROR) and the reply text.
+const char PROTOCOL_MAGIC[] = "MSTB";
+const size_t PROTOCOL_MAGIC_SIZE = 4;
+const uint8_t PROTOCOL_VERSION = 1;
+const uint32_t MAX_FRAME_SIZE = 1u << 28;       // 22M edge records
+const size_t EDGE_RECORD_SIZE = 12;
+
+enum FrameType : uint8_t {
+    FRAME_HELLO = 0,            // made by the framer from the magic bytes, never sent as a frame
+    FRAME_TEXT = 1,
+    FRAME_NEW_GRAPH = 2,
+    FRAME_ADD_EDGES = 3,
+    FRAME_TOO_LARGE = 0xff      // made by the framer for a frame above MAX_FRAME_SIZE (skipped)
+};
+
+enum ReplyStatus : uint8_t {
+    REPLY_OK = 0,
+    REPLY_ERROR = 1
+};
+
+void putU32(std::string& out, uint32_t value);
+uint32_t readU32(const char* data);
+int32_t readI32(const char* data);
+
+// A whole frame: length prefix, type (or status) byte and payload
+std::string encodeFrame(uint8_t type, const std::string& payload);
+
+// Edge records of edges, back to back
+std::string encodeEdges(const std::vector<Edge>& edges);
+
+// Add count edge records from data to graph, skipping edges with an end out of range and
+// duplicates. Returns the number of edges the graph gained
+uint32_t addEdgeRecords(Graph& graph, const char* data, uint32_t count);
+
+#endif // WIRE_PROTOCOL_HPP